@@ -0,0 +1,171 @@
+#!/usr/bin/env ruby
+# frozen_string_literal: true
+
+# Benchmark the binding against the fixed corpus in experiments/bench_corpus.txt and
+# print the results as JSON, so they can be compared between releases of the binding
+# and of link-grammar. Run it with `rake bench`, or directly:
+#
+#   ruby experiments/bench.rb [--iterations N] [--threads N] [--output FILE] [CORPUS]
+
+require 'pathname'
+require 'json'
+require 'optparse'
+require 'etc'
+require 'time'
+
+basedir = Pathname(__FILE__).dirname.parent
+
+$LOAD_PATH.unshift( basedir + 'lib' )
+$LOAD_PATH.unshift( basedir + 'ext' )
+
+require 'linkparser'
+
+
+# Sentence lengths (in words) that latencies are grouped by
+LENGTH_BUCKETS = {
+	'1-5'   => 1..5,
+	'6-10'  => 6..10,
+	'11-20' => 11..20,
+	'21+'   => 21..,
+}
+
+# The percentiles reported for each group of latencies
+PERCENTILES = [ 50, 95, 99 ]
+
+
+### Return the +pct+th percentile of the sorted Array of +values+ using the
+### nearest-rank method.
+def percentile( values, pct )
+	return nil if values.empty?
+	rank = ( pct / 100.0 * values.length ).ceil - 1
+	return values[ rank.clamp(0, values.length - 1) ]
+end
+
+
+### Return a Hash of the percentiles of the given latencies (in seconds) in
+### milliseconds.
+def latency_summary( latencies )
+	sorted = latencies.sort
+	summary = { count: sorted.length }
+	PERCENTILES.each do |pct|
+		value = percentile( sorted, pct )
+		summary[ "p#{pct}_ms".to_sym ] = value && ( value * 1000 ).round( 3 )
+	end
+
+	return summary
+end
+
+
+### Return the resident set size of the current process in kilobytes, or nil if
+### it can't be determined.
+def rss_kb
+	if File.readable?( '/proc/self/status' )
+		line = File.foreach( '/proc/self/status' ).find {|l| l.start_with?('VmRSS:') }
+		return line[ /\d+/ ].to_i if line
+	end
+
+	rss = `ps -o rss= -p #{Process.pid} 2>/dev/null`.strip
+	return rss.empty? ? nil : rss.to_i
+end
+
+
+### Return the current value of the monotonic clock in seconds.
+def now
+	return Process.clock_gettime( Process::CLOCK_MONOTONIC )
+end
+
+
+iterations = 5
+threads = Etc.nprocessors
+output = nil
+
+OptionParser.new do |opts|
+	opts.banner = "Usage: #$0 [options] [CORPUS]"
+	opts.on( '-i', '--iterations N', Integer, "Times to parse the corpus (#{iterations})" ) {|n| iterations = n }
+	opts.on( '-t', '--threads N', Integer, "Threads for the batch run (#{threads})" ) {|n| threads = n }
+	opts.on( '-o', '--output FILE', "Write the JSON to FILE instead of STDOUT" ) {|f| output = f }
+end.parse!
+
+corpus_file = ARGV.shift || basedir + 'experiments/bench_corpus.txt'
+corpus = File.readlines( corpus_file, chomp: true ).
+	reject {|line| line.strip.empty? || line.start_with?('#') }
+
+LinkParser.logger.level = :fatal
+dict = LinkParser::Dictionary.new( 'en', verbosity: 0 )
+
+# Warm up so dictionary loading and first-use costs aren't counted
+corpus.each {|text| dict.parse(text).linkages.first&.links }
+
+rss_before = rss_kb()
+latencies = Hash.new {|h, k| h[k] = [] }
+allocations = 0
+parse_count = 0
+
+GC.start
+sequential_start = now()
+iterations.times do
+	corpus.each do |text|
+		bucket = LENGTH_BUCKETS.find {|_, range| range.cover?(text.split.length) }.first
+		allocated = GC.stat( :total_allocated_objects )
+		start = now()
+
+		sentence = dict.parse( text )
+		sentence.linkages.first&.links
+
+		latencies[ bucket ] << now() - start
+		allocations += GC.stat( :total_allocated_objects ) - allocated
+		parse_count += 1
+	end
+end
+sequential_time = now() - sequential_start
+
+batch_start = now()
+iterations.times do
+	dict.parse_batch( corpus, threads: threads ).each do |sentence|
+		sentence.linkages.first&.links
+		sentence.release!
+	end
+end
+batch_time = now() - batch_start
+
+GC.start
+rss_after = rss_kb()
+
+results = {
+	timestamp: Time.now.utc.iso8601,
+	ruby: RUBY_DESCRIPTION,
+	linkparser: LinkParser::VERSION,
+	link_grammar: LinkParser.link_grammar_version,
+	corpus: {
+		file: File.basename( corpus_file.to_s ),
+		sentences: corpus.length,
+		iterations: iterations,
+	},
+	sequential: {
+		sentences_per_sec: ( parse_count / sequential_time ).round( 2 ),
+		seconds: sequential_time.round( 4 ),
+		allocations_per_parse: ( allocations.to_f / parse_count ).round( 1 ),
+		latency: latency_summary( latencies.values.flatten ),
+		latency_by_length: LENGTH_BUCKETS.keys.each_with_object( {} ) do |bucket, hash|
+			hash[ bucket ] = latency_summary( latencies[bucket] ) if latencies.key?( bucket )
+		end,
+	},
+	batch: {
+		threads: threads,
+		sentences_per_sec: ( corpus.length * iterations / batch_time ).round( 2 ),
+		seconds: batch_time.round( 4 ),
+	},
+	rss_kb: {
+		before: rss_before,
+		after: rss_after,
+		growth: rss_before && rss_after && ( rss_after - rss_before ),
+	},
+}
+
+json = JSON.pretty_generate( results )
+if output
+	File.write( output, json + "\n" )
+else
+	puts json
+end
+
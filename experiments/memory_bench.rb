@@ -0,0 +1,168 @@
+#!/usr/bin/env ruby
+# frozen_string_literal: true
+
+# Check the binding's estimates of link-grammar's memory use (the RLINK_*_BYTES
+# figures in ext/linkparser_ext/linkparser.h, reported by ObjectSpace.memsize_of and
+# to the GC) against how much the process's RSS actually grows, and print the
+# results as JSON. Each phase runs in a forked child so they don't disturb each
+# other:
+#
+# [dictionary] loading a Dictionary
+# [tokenize]   creating a Sentence for each line of the corpus
+# [parse]      parsing those Sentences
+#
+# The Ruby heap's own growth is subtracted from the RSS growth, so what's left is
+# (roughly) link-grammar's. Run it with `rake bench:memory`, or directly:
+#
+#   ruby experiments/memory_bench.rb [--repeat N] [--lang LANG] [--check FACTOR]
+#                                    [--output FILE] [CORPUS]
+#
+# With --check, it exits with a failure status if any estimate is off from the
+# measured growth by more than FACTOR either way.
+
+require 'pathname'
+require 'json'
+require 'objspace'
+require 'optparse'
+require 'time'
+
+basedir = Pathname(__FILE__).dirname.parent
+
+$LOAD_PATH.unshift( basedir + 'lib' )
+$LOAD_PATH.unshift( basedir + 'ext' )
+
+require 'linkparser'
+
+
+### Return the resident set size of the current process in kilobytes, or nil if
+### it can't be determined.
+def rss_kb
+	if File.readable?( '/proc/self/status' )
+		line = File.foreach( '/proc/self/status' ).find {|l| l.start_with?('VmRSS:') }
+		return line[ /\d+/ ].to_i if line
+	end
+
+	rss = `ps -o rss= -p #{Process.pid} 2>/dev/null`.strip
+	return rss.empty? ? nil : rss.to_i
+end
+
+
+### Run the block in a forked child with the GC disabled and return how much the
+### RSS grew while it ran, along with the number of bytes it returns as the
+### estimate of that growth (less the Ruby heap's). If a +setup+ callable is given,
+### it's called first, outside of the measurement, and what it returns is passed
+### to the block.
+def measure( setup=nil )
+	reader, writer = IO.pipe
+
+	pid = fork do
+		reader.close
+		state = setup&.call
+		GC.start
+		GC.disable
+		rss_before = rss_kb()
+		heap_before = ObjectSpace.memsize_of_all
+
+		estimated = yield( state )
+
+		heap_growth = ObjectSpace.memsize_of_all - heap_before - estimated
+		measured = ( rss_kb() - rss_before ) * 1024 - heap_growth
+		writer.write( JSON.generate(estimated: estimated, measured: measured) )
+		writer.close
+		exit!( 0 )
+	end
+
+	writer.close
+	result = JSON.parse( reader.read, symbolize_names: true )
+	Process.wait( pid )
+
+	return summarize( result )
+ensure
+	reader&.close
+end
+
+
+### Add the ratio of the estimated to the measured bytes to the +result+ and
+### convert the byte counts to kilobytes.
+def summarize( result )
+	ratio = result[:measured] > 0 ? ( result[:estimated].to_f / result[:measured] ).round( 2 ) : nil
+
+	return {
+		estimated_kb: result[:estimated] / 1024,
+		measured_kb: result[:measured] / 1024,
+		ratio: ratio,
+	}
+end
+
+
+repeat = 20
+lang = 'en'
+check = nil
+output = nil
+
+OptionParser.new do |opts|
+	opts.banner = "Usage: #$0 [options] [CORPUS]"
+	opts.on( '-r', '--repeat N', Integer, "Copies of the corpus to hold at once (#{repeat})" ) {|n| repeat = n }
+	opts.on( '-l', '--lang LANG', "Dictionary language (#{lang})" ) {|l| lang = l }
+	opts.on( '-c', '--check FACTOR', Float, "Fail if an estimate is off by more than FACTOR" ) {|f| check = f }
+	opts.on( '-o', '--output FILE', "Write the JSON to FILE instead of STDOUT" ) {|f| output = f }
+end.parse!
+
+abort "This benchmark needs fork(2)" unless Process.respond_to?( :fork )
+abort "Can't read this platform's RSS" unless rss_kb()
+
+corpus_file = ARGV.shift || basedir + 'experiments/bench_corpus.txt'
+corpus = File.readlines( corpus_file, chomp: true ).
+	reject {|line| line.strip.empty? || line.start_with?('#') }
+inputs = corpus * repeat
+
+LinkParser.logger.level = :fatal
+
+dictionary = measure do
+	dict = LinkParser::Dictionary.new( lang, verbosity: 0 )
+	ObjectSpace.memsize_of( dict )
+end
+
+dict = LinkParser::Dictionary.new( lang, verbosity: 0 )
+
+tokenize = measure do
+	sentences = inputs.map {|text| LinkParser::Sentence.new(text, dict) }
+	sentences.sum {|sentence| ObjectSpace.memsize_of(sentence) }
+end
+
+parse = measure( -> { inputs.map {|text| LinkParser::Sentence.new(text, dict) } } ) do |sentences|
+	unparsed = sentences.sum {|sentence| ObjectSpace.memsize_of(sentence) }
+	sentences.each( &:parse )
+	sentences.sum {|sentence| ObjectSpace.memsize_of(sentence) } - unparsed
+end
+
+results = {
+	timestamp: Time.now.utc.iso8601,
+	ruby: RUBY_DESCRIPTION,
+	linkparser: LinkParser::VERSION,
+	link_grammar: LinkParser.link_grammar_version,
+	lang: lang,
+	corpus: {
+		file: File.basename( corpus_file.to_s ),
+		sentences: corpus.length,
+		repeat: repeat,
+	},
+	dictionary: dictionary,
+	tokenize: tokenize,
+	parse: parse,
+}
+
+json = JSON.pretty_generate( results )
+if output
+	File.write( output, json + "\n" )
+else
+	puts json
+end
+
+if check
+	off = [ :dictionary, :tokenize, :parse ].reject do |phase|
+		ratio = results[ phase ][ :ratio ]
+		ratio && ratio.between?( 1 / check, check )
+	end
+	abort "Estimates off by more than a factor of #{check}: #{off.join(', ')}" unless off.empty?
+end
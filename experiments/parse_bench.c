@@ -0,0 +1,125 @@
+/*
+ * Benchmark link-grammar itself (without the Ruby binding) against the same
+ * corpus as experiments/bench.rb, so the binding's overhead can be told apart
+ * from the library's. Prints JSON to stdout.
+ *
+ *   cc -O2 -o parse_bench experiments/parse_bench.c \
+ *       $(pkg-config --cflags --libs link-grammar)
+ *   ./parse_bench [corpus] [iterations]
+ */
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "link-grammar/link-includes.h"
+
+#define MAX_SENTENCES 1024
+#define MAX_LINE 4096
+
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of the sorted array +values+, in milliseconds */
+static double percentile(const double *values, size_t count, int pct)
+{
+    size_t rank = (size_t)((pct / 100.0) * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return values[rank - 1] * 1000.0;
+}
+
+static long max_rss_kb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+int main(int argc, char **argv)
+{
+    const char *corpus_file = argc > 1 ? argv[1] : "experiments/bench_corpus.txt";
+    int iterations = argc > 2 ? atoi(argv[2]) : 5;
+    char *sentences[MAX_SENTENCES];
+    char line[MAX_LINE];
+    size_t count = 0, parses = 0, i;
+    int iter;
+    double *latencies, start, elapsed;
+    long rss_before;
+    Dictionary dict;
+    Parse_Options opts;
+    FILE *corpus;
+
+    setlocale(LC_ALL, "");
+
+    if (!(corpus = fopen(corpus_file, "r"))) {
+        perror(corpus_file);
+        return 1;
+    }
+    while (count < MAX_SENTENCES && fgets(line, sizeof(line), corpus)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') continue;
+        sentences[count++] = strdup(line);
+    }
+    fclose(corpus);
+
+    opts = parse_options_create();
+    parse_options_set_verbosity(opts, 0);
+    dict = dictionary_create_lang("en");
+    if (!dict) {
+        printf ("Fatal error: Unable to open the dictionary\n");
+        return 1;
+    }
+
+    latencies = malloc(sizeof(double) * count * iterations);
+    rss_before = max_rss_kb();
+    elapsed = 0.0;
+
+    for (iter = 0; iter < iterations; iter++) {
+        for (i = 0; i < count; i++) {
+            Sentence sent;
+
+            start = now();
+            sent = sentence_create(sentences[i], dict);
+            if (sentence_parse(sent, opts) > 0) {
+                Linkage linkage = linkage_create(0, sent, opts);
+                if (linkage) linkage_delete(linkage);
+            }
+            sentence_delete(sent);
+
+            latencies[parses] = now() - start;
+            elapsed += latencies[parses++];
+        }
+    }
+
+    qsort(latencies, parses, sizeof(double), compare_doubles);
+
+    printf("{\n");
+    printf("  \"link_grammar\": \"%s\",\n", linkgrammar_get_version());
+    printf("  \"corpus\": { \"sentences\": %zu, \"iterations\": %d },\n", count, iterations);
+    printf("  \"sentences_per_sec\": %.2f,\n", parses / elapsed);
+    printf("  \"latency\": { \"count\": %zu, \"p50_ms\": %.3f, \"p95_ms\": %.3f, \"p99_ms\": %.3f },\n",
+        parses, percentile(latencies, parses, 50), percentile(latencies, parses, 95),
+        percentile(latencies, parses, 99));
+    printf("  \"max_rss_kb\": { \"before\": %ld, \"after\": %ld }\n", rss_before, max_rss_kb());
+    printf("}\n");
+
+    for (i = 0; i < count; i++) free(sentences[i]);
+    free(latencies);
+    dictionary_delete(dict);
+    parse_options_delete(opts);
+
+    return 0;
+}
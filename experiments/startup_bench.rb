@@ -0,0 +1,147 @@
+#!/usr/bin/env ruby
+# frozen_string_literal: true
+
+# Compare the two ways a forked worker can get a Dictionary and print the results
+# as JSON:
+#
+# [cold]      the worker loads its own with Dictionary.new
+# [preloaded] the master loads it once with Dictionary.preload before forking, and
+#             the worker gets it from Dictionary.shared
+#
+# For each, it reports the time from fork until the worker has parsed its first
+# sentence, and how much of the worker's memory is private vs. still shared with
+# the master. Run it with `rake bench:startup`, or directly:
+#
+#   ruby experiments/startup_bench.rb [--workers N] [--lang LANG] [--output FILE]
+
+require 'pathname'
+require 'json'
+require 'optparse'
+require 'time'
+
+basedir = Pathname(__FILE__).dirname.parent
+
+$LOAD_PATH.unshift( basedir + 'lib' )
+$LOAD_PATH.unshift( basedir + 'ext' )
+
+require 'linkparser'
+
+
+# The sentence each worker parses before it counts as started
+FIRST_SENTENCE = "The dog plays with the ball."
+
+
+### Return a Hash of the current process's private and shared memory in
+### kilobytes, or nil if it can't be determined.
+def memory_kb
+	path = File.readable?( '/proc/self/smaps_rollup' ) ? '/proc/self/smaps_rollup' : nil
+	return nil unless path
+
+	totals = Hash.new( 0 )
+	File.foreach( path ) do |line|
+		key, value = line.split( ':', 2 )
+		next unless value
+		case key
+		when 'Rss' then totals[ :rss ] += value.to_i
+		when 'Private_Clean', 'Private_Dirty' then totals[ :private ] += value.to_i
+		when 'Shared_Clean', 'Shared_Dirty' then totals[ :shared ] += value.to_i
+		end
+	end
+
+	return totals
+end
+
+
+### Return the current value of the monotonic clock in seconds.
+def now
+	return Process.clock_gettime( Process::CLOCK_MONOTONIC )
+end
+
+
+### Fork a worker that gets a Dictionary by calling the block, parses
+### FIRST_SENTENCE with it, and reports how long that took and its memory use.
+def time_worker
+	reader, writer = IO.pipe
+	start = now()
+
+	pid = fork do
+		reader.close
+		dict = yield
+		dict.parse( FIRST_SENTENCE ).linkages.first
+		writer.write( JSON.generate(seconds: now() - start, memory_kb: memory_kb()) )
+		writer.close
+		exit!( 0 )
+	end
+
+	writer.close
+	result = JSON.parse( reader.read, symbolize_names: true )
+	Process.wait( pid )
+
+	return result
+ensure
+	reader&.close
+end
+
+
+### Return the mean of the given +values+, rounded.
+def mean( values, digits=4 )
+	return nil if values.empty?
+	return ( values.sum.to_f / values.length ).round( digits )
+end
+
+
+### Summarize the results of several workers.
+def summarize( results )
+	return {
+		workers: results.length,
+		mean_seconds: mean( results.map {|r| r[:seconds] } ),
+		max_seconds: results.map {|r| r[:seconds] }.max&.round( 4 ),
+		mean_private_kb: mean( results.filter_map {|r| r.dig(:memory_kb, :private) }, 0 ),
+		mean_shared_kb: mean( results.filter_map {|r| r.dig(:memory_kb, :shared) }, 0 ),
+	}
+end
+
+
+workers = 3
+lang = 'en'
+output = nil
+
+OptionParser.new do |opts|
+	opts.banner = "Usage: #$0 [options]"
+	opts.on( '-w', '--workers N', Integer, "Workers to fork for each mode (#{workers})" ) {|n| workers = n }
+	opts.on( '-l', '--lang LANG', "Dictionary language (#{lang})" ) {|l| lang = l }
+	opts.on( '-o', '--output FILE', "Write the JSON to FILE instead of STDOUT" ) {|f| output = f }
+end.parse!
+
+abort "This benchmark needs fork(2)" unless Process.respond_to?( :fork )
+LinkParser.logger.level = :fatal
+
+cold = workers.times.map do
+	time_worker { LinkParser::Dictionary.new(lang, verbosity: 0) }
+end
+
+preload_start = now()
+LinkParser::Dictionary.preload( lang )
+preload_time = now() - preload_start
+
+preloaded = workers.times.map do
+	time_worker { LinkParser::Dictionary.shared(lang, verbosity: 0) }
+end
+
+results = {
+	timestamp: Time.now.utc.iso8601,
+	ruby: RUBY_DESCRIPTION,
+	linkparser: LinkParser::VERSION,
+	link_grammar: LinkParser.link_grammar_version,
+	lang: lang,
+	cold: summarize( cold ),
+	preloaded: summarize( preloaded ).merge( master_preload_seconds: preload_time.round(4) ),
+}
+
+json = JSON.pretty_generate( results )
+if output
+	File.write( output, json + "\n" )
+else
+	puts json
+end
+
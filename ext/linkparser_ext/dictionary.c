@@ -12,6 +12,17 @@
 #include "linkparser.h"
 
 
+/* --------------------------------------------------
+ * Macros and constants
+ * -------------------------------------------------- */
+
+static VALUE threads_sym;
+static VALUE top_k_sym;
+
+/* The most compiled ParseOptions a Dictionary will cache before starting over */
+#define RLINK_OPTIONS_CACHE_MAX 32
+
+
 /* --------------------------------------------------
  *  Memory management functions
  * -------------------------------------------------- */
@@ -26,12 +37,75 @@ rlink_dictionary_alloc()
 	struct rlink_dictionary *ptr = ALLOC( struct rlink_dictionary );
 
 	ptr->dict	= NULL;
+	ptr->ref	= NULL;
+	ptr->parent	= Qnil;
+	ptr->options_cache = Qnil;
+	ptr->options_snapshot = Qnil;
 
 	rlink_log( "debug", "Initialized an rlink_dictionary <%p>", ptr );
 	return ptr;
 }
 
 
+/*
+ * Return a new rlink_dict_ref for the newly-loaded +dict+, with one user, and
+ * tell the GC about the (estimated) memory it uses.
+ */
+static struct rlink_dict_ref *
+rlink_dict_ref_new( Dictionary dict )
+{
+	struct rlink_dict_ref *ref = ALLOC( struct rlink_dict_ref );
+
+	ref->dict = dict;
+	ref->refcount = 1;
+	ref->native_size = RLINK_DICTIONARY_BYTES;
+	rlink_adjust_memory_usage( (ssize_t)ref->native_size );
+
+	return ref;
+}
+
+
+/*
+ * Add a user to the given +ref+ and return it.
+ */
+struct rlink_dict_ref *
+rlink_dict_ref_retain( struct rlink_dict_ref *ref )
+{
+	ref->refcount++;
+	return ref;
+}
+
+
+/*
+ * Remove a user from the given +ref+, deleting the link-grammar Dictionary if it
+ * was the last one. Doesn't call any Ruby code, so it's safe to use from a free
+ * function.
+ */
+void
+rlink_dict_ref_release( struct rlink_dict_ref *ref )
+{
+	if ( ref && --ref->refcount == 0 ) {
+		dictionary_delete( ref->dict );
+		rlink_adjust_memory_usage( -(ssize_t)ref->native_size );
+		xfree( ref );
+	}
+}
+
+
+/*
+ * GC Mark function
+ */
+static void
+rlink_dict_gc_mark( struct rlink_dictionary *ptr )
+{
+	if ( ptr ) {
+		rb_gc_mark( ptr->parent );
+		rb_gc_mark( ptr->options_cache );
+		rb_gc_mark( ptr->options_snapshot );
+	}
+}
+
+
 /*
  * Free function
  */
@@ -39,9 +113,9 @@ static void
 rlink_dict_gc_free( struct rlink_dictionary *ptr )
 {
 	if ( ptr ) {
-		if ( ptr->dict )
-			dictionary_delete( ptr->dict );
-
+		/* Copies and Sentences share the dictionary, so the last one deletes it */
+		rlink_dict_ref_release( ptr->ref );
+		ptr->ref = NULL;
 		ptr->dict = NULL;
 
 		xfree( ptr );
@@ -50,20 +124,46 @@ rlink_dict_gc_free( struct rlink_dictionary *ptr )
 }
 
 
+/*
+ * GC Size function. The link-grammar dictionary is counted for the Dictionary that
+ * loaded it, not its copies.
+ */
+static size_t
+rlink_dict_memsize( const struct rlink_dictionary *ptr )
+{
+	if ( !ptr ) return 0;
+	if ( ptr->ref && NIL_P(ptr->parent) )
+		return sizeof( struct rlink_dictionary ) + ptr->ref->native_size;
+
+	return sizeof( struct rlink_dictionary );
+}
+
+
+static const rb_data_type_t rlink_dictionary_type = {
+	"LinkParser::Dictionary",
+	{
+		(RUBY_DATA_FUNC)rlink_dict_gc_mark,
+		(RUBY_DATA_FUNC)rlink_dict_gc_free,
+		(size_t (*)(const void *))rlink_dict_memsize,
+	},
+	0,
+	0,
+	RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+
 /*
  * Object validity checker. Returns the data pointer.
  */
 static struct rlink_dictionary *
 check_dict( VALUE self )
 {
-	Check_Type( self, T_DATA );
-
-    if ( !IsDictionary(self) ) {
+    if ( !rb_typeddata_is_kind_of(self, &rlink_dictionary_type) ) {
 		rb_raise( rb_eTypeError, "wrong argument type %s (expected LinkParser::Dictionary)",
 				  rb_class2name(CLASS_OF( self )) );
     }
 
-	return DATA_PTR( self );
+	return RTYPEDDATA_DATA( self );
 }
 
 
@@ -93,6 +193,102 @@ rlink_get_dict( VALUE obj )
 
 
 
+/*
+ * Return the number of threads to use for a batch parse if none is specified:
+ * the number of online CPUs if it can be determined, or 1 if not.
+ */
+static long
+rlink_default_thread_count()
+{
+#if defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+	long count = sysconf( _SC_NPROCESSORS_ONLN );
+	if ( count > 0 ) return count;
+#endif
+	return 1;
+}
+
+
+
+/*
+ * Return the number of linkages a sentence parsed with the given +overrides+ (a Hash
+ * or nil) should keep, or 0 if it should keep all of them. This is the +:top_k+
+ * override, which has to be at least 1. link-grammar sorts the linkages it
+ * post-processes by cost, so the first +top_k+ of them are the best ones.
+ */
+int
+rlink_dict_top_k( VALUE overrides )
+{
+	VALUE top_k;
+	int count;
+
+	if ( TYPE(overrides) != T_HASH || NIL_P(top_k = rb_hash_lookup(overrides, top_k_sym)) )
+		return 0;
+
+	count = NUM2INT( top_k );
+	if ( count < 1 )
+		rb_raise( rb_eArgError, "top_k must be at least 1 (got %d)", count );
+
+	return count;
+}
+
+
+/*
+ * Return a new LinkParser::ParseOptions for parsing a sentence with the Dictionary
+ * +self+, with the settings in the +overrides+ Hash (which may be nil) applied on
+ * top of the Dictionary's options.
+ *
+ * Merging the option Hashes and building a ParseOptions from them is done in Ruby
+ * and is much more expensive than the parse setup it's for, so the result is
+ * compiled once per distinct +overrides+ Hash and kept in the Dictionary. Each call
+ * then only has to copy it, since link-grammar keeps per-parse state in its
+ * Parse_Options. The cache is dropped if the Dictionary's options are changed.
+ *
+ * A +:top_k+ override isn't a parse option (see rlink_dict_top_k), so it's left out.
+ */
+VALUE
+rlink_dict_parse_options( VALUE self, VALUE overrides )
+{
+	struct rlink_dictionary *ptr = get_dict( self );
+	VALUE defopts = rb_funcall( self, rb_intern("options"), 0 );
+	VALUE key = Qnil, cache, snapshot, template;
+
+	if ( TYPE(overrides) == T_HASH && rb_hash_lookup2(overrides, top_k_sym, Qundef) != Qundef ) {
+		overrides = rb_hash_dup( overrides );
+		rb_hash_delete( overrides, top_k_sym );
+	}
+
+	/* Only plain Hashes are cached; anything else could be changed behind our back */
+	if ( TYPE(defopts) != T_HASH || (!NIL_P(overrides) && TYPE(overrides) != T_HASH) )
+		return rlink_copy_parse_options( rlink_make_parse_options(defopts, overrides) );
+	if ( !NIL_P(overrides) && RHASH_SIZE(overrides) != 0 )
+		key = overrides;
+
+	if ( NIL_P(ptr->options_snapshot) || !rb_equal(ptr->options_snapshot, defopts) ) {
+		rlink_log_obj( self, "debug", "Dictionary options changed; clearing the options cache." );
+		ptr->options_cache = rb_hash_new();
+		ptr->options_snapshot = rb_obj_freeze( rb_hash_dup(defopts) );
+	}
+
+	/* Building the options can switch threads, so hang on to the cache it's for */
+	cache = ptr->options_cache;
+	snapshot = ptr->options_snapshot;
+
+	template = rb_hash_lookup( cache, key );
+	if ( NIL_P(template) ) {
+		template = rlink_make_parse_options( snapshot, overrides );
+
+		if ( RHASH_SIZE(cache) >= RLINK_OPTIONS_CACHE_MAX )
+			rb_hash_clear( cache );
+		if ( !NIL_P(key) )
+			key = rb_obj_freeze( rb_hash_dup(key) );
+		rb_hash_aset( cache, key, template );
+	}
+
+	return rlink_copy_parse_options( template );
+}
+
+
+
 /* --------------------------------------------------
  * Class Methods
  * -------------------------------------------------- */
@@ -108,7 +304,7 @@ static VALUE
 rlink_dict_s_alloc( VALUE klass )
 {
 	rlink_log( "debug", "Wrapping an uninitialized Dictionary pointer." );
-	return Data_Wrap_Struct( klass, 0, rlink_dict_gc_free, 0 );
+	return TypedData_Wrap_Struct( klass, &rlink_dictionary_type, 0 );
 }
 
 
@@ -190,7 +386,10 @@ rlink_dict_initialize( int argc, VALUE *argv, VALUE self )
 		VALUE arg1, arg2, arg3, arg4, arg5 = Qnil;
 		VALUE lang = Qnil;
 		VALUE opthash = Qnil;
+		struct rlink_timer timer;
+		double duration, cpu_time;
 
+		rlink_timer_start( &timer );
 		switch( i = rb_scan_args(argc, argv, "05", &arg1, &arg2, &arg3, &arg4, &arg5) ) {
 		  /* Dictionary.new */
 		  case 0:
@@ -241,6 +440,16 @@ rlink_dict_initialize( int argc, VALUE *argv, VALUE self )
 			}
 		}
 
+		if ( rlink_subscribed(RLINK_EVENT_DICTIONARY_LOAD) ) {
+			VALUE payload = rb_hash_new();
+
+			rlink_timer_stop( &timer, &duration, &cpu_time );
+			rb_hash_aset( payload, ID2SYM(rb_intern("language")), RTEST(lang) ? lang : Qnil );
+			rb_hash_aset( payload, ID2SYM(rb_intern("outcome")),
+				ID2SYM(rb_intern(dict ? "success" : "error")) );
+			rlink_publish_event( "dictionary_load", duration, payload );
+		}
+
 		/* If the dictionary still isn't created, there was an error
 		   creating it */
 		if ( !dict ) rlink_raise_lp_error();
@@ -249,6 +458,7 @@ rlink_dict_initialize( int argc, VALUE *argv, VALUE self )
 		DATA_PTR( self ) = ptr = rlink_dictionary_alloc();
 
 		ptr->dict = dict;
+		ptr->ref = rlink_dict_ref_new( dict );
 
 		/* If they passed in an options hash, save it for later. */
 		if ( RTEST(opthash) ) {
@@ -266,6 +476,59 @@ rlink_dict_initialize( int argc, VALUE *argv, VALUE self )
 }
 
 
+/*
+ *  call-seq:
+ *     dictionary.dup   -> dictionary
+ *
+ *  Copy constructor -- the copy shares the link-grammar dictionary of the
+ *  original instead of loading it again, but has its own copy of the options.
+ */
+static VALUE
+rlink_dict_init_copy( VALUE self, VALUE other )
+{
+	if ( !check_dict(self) ) {
+		struct rlink_dictionary *other_ptr = get_dict( other ), *ptr;
+		VALUE opthash = rb_iv_get( other, "@options" );
+
+		rlink_log_obj( self, "debug", "Sharing dictionary %p", other_ptr->dict );
+		DATA_PTR( self ) = ptr = rlink_dictionary_alloc();
+
+		ptr->dict = other_ptr->dict;
+		ptr->ref = rlink_dict_ref_retain( other_ptr->ref );
+		ptr->parent = NIL_P( other_ptr->parent ) ? other : other_ptr->parent;
+
+		rb_iv_set( self, "@options", NIL_P(opthash) ? rb_hash_new() : rb_hash_dup(opthash) );
+		rb_call_super( 1, &other );
+	}
+
+	else {
+		rb_raise( rb_eRuntimeError, "Can't recopy a Dictionary object." );
+	}
+
+	return self;
+}
+
+
+/*
+ *  call-seq:
+ *     dictionary.effective_options( overrides={} )   -> parseoptions
+ *
+ *  Return a new LinkParser::ParseOptions with the options a sentence parsed with
+ *  the given +overrides+ would use: the Dictionary's, with the +overrides+ applied
+ *  on top. A +:top_k+ override isn't a parse option, so it doesn't appear in them.
+ *
+ *     dict.effective_options( max_null_count: 3 ).max_null_count   #-> 3
+ */
+static VALUE
+rlink_dict_effective_options( int argc, VALUE *argv, VALUE self )
+{
+	VALUE overrides = Qnil;
+
+	rb_scan_args( argc, argv, "01", &overrides );
+	return rlink_dict_parse_options( self, overrides );
+}
+
+
 /*
  *  call-seq:
  *     dictionary.parse( string )            -> sentence
@@ -299,6 +562,39 @@ rlink_parse( int argc, VALUE *argv, VALUE self )
 }
 
 
+/*
+ *  call-seq:
+ *     dictionary.parse_batch( strings, threads: ncpus, **options )   -> array
+ *
+ *  Parse each of the specified sentence +strings+ with the dictionary and return an
+ *  Array of LinkParser::Sentence objects in the same order. The sentences are created
+ *  and parsed by a pool of up to +threads+ native threads (by default, one per CPU)
+ *  without holding the GVL, and any +options+ given override those of the Dictionary
+ *  for every sentence in the batch.
+ *
+ *     sentences = dict.parse_batch( lines, threads: 8, max_parse_time: 2 )
+ */
+static VALUE
+rlink_parse_batch( int argc, VALUE *argv, VALUE self )
+{
+	VALUE strings, opthash = Qnil, threads, options;
+	long nthreads;
+	int top_k;
+
+	rb_scan_args( argc, argv, "1:", &strings, &opthash );
+	opthash = NIL_P( opthash ) ? rb_hash_new() : rb_hash_dup( opthash );
+
+	threads = rb_hash_delete( opthash, threads_sym );
+	nthreads = NIL_P( threads ) ? rlink_default_thread_count() : NUM2LONG( threads );
+	if ( nthreads < 1 )
+		rb_raise( rb_eArgError, "thread count must be at least 1 (got %ld)", nthreads );
+
+	/* Build the options once for the whole batch */
+	top_k = rlink_dict_top_k( opthash );
+	options = rlink_dict_parse_options( self, opthash );
+
+	return rlink_sentence_parse_batch( self, strings, options, top_k, nthreads );
+}
 
 
 
@@ -321,8 +617,14 @@ rlink_init_dict()
 
 	rb_define_alloc_func( rlink_cDictionary, rlink_dict_s_alloc );
 	rb_define_method( rlink_cDictionary, "initialize", rlink_dict_initialize, -1 );
+	rb_define_method( rlink_cDictionary, "initialize_copy", rlink_dict_init_copy, 1 );
+
+	threads_sym = ID2SYM( rb_intern("threads") );
+	top_k_sym = ID2SYM( rb_intern("top_k") );
 
+	rb_define_method( rlink_cDictionary, "effective_options", rlink_dict_effective_options, -1 );
 	rb_define_method( rlink_cDictionary, "parse", rlink_parse, -1 );
+	rb_define_method( rlink_cDictionary, "parse_batch", rlink_parse_batch, -1 );
 
 	/* The LinkParser::ParseOptions object for the Dictionary */
 	rb_define_attr( rlink_cDictionary, "options", 1, 0 );
@@ -0,0 +1,452 @@
+/*
+ *  dump.c - Ruby LinkParser - binary encoding of parse results
+ *  $Id$
+ *
+ *  Authors:
+ *    * Michael Granger <ged@FaerieMUD.org>
+ *
+ *  Please see the LICENSE file at the top of the distribution for licensing
+ *  information.
+ */
+
+#include "linkparser.h"
+
+
+/* --------------------------------------------------
+ * Macros and constants
+ * -------------------------------------------------- */
+
+/*
+ * The encoding is a record header followed by a body, both made of unsigned
+ * 32-bit little-endian integers and strings (a 32-bit length followed by that
+ * many bytes, or a length of RLINK_DUMP_NIL for nil):
+ *
+ *   header:  "LPRS" version(u8) body-length(u32)
+ *   body:    text null_count num_linkages_found num_linkages linkage*
+ *   linkage: unused_word_cost disjunct_cost link_cost violation_name
+ *            num_words word* num_links link* disjunct_string{num_words}
+ *   link:    lword rword length label llabel rlabel
+ *
+ * Costs and link lengths are signed. Records are self-delimiting, so a stream
+ * of them can be written one after another.
+ */
+#define RLINK_DUMP_MAGIC       "LPRS"
+#define RLINK_DUMP_MAGIC_LEN   4
+#define RLINK_DUMP_VERSION     1
+#define RLINK_DUMP_HEADER_LEN  ( RLINK_DUMP_MAGIC_LEN + 1 + 4 )
+#define RLINK_DUMP_NIL         0xFFFFFFFFUL
+
+static VALUE words_sym;
+static VALUE links_sym;
+static VALUE disjunct_strings_sym;
+static VALUE unused_word_cost_sym;
+static VALUE disjunct_cost_sym;
+static VALUE link_cost_sym;
+static VALUE violation_name_sym;
+static VALUE text_sym;
+static VALUE null_count_sym;
+static VALUE num_linkages_found_sym;
+static VALUE linkages_sym;
+
+/* The state of a dump being read */
+struct rlink_dump_reader {
+	const unsigned char *pos;
+	const unsigned char *end;
+};
+
+
+/* --------------------------------------------------
+ * Writing
+ * -------------------------------------------------- */
+
+/*
+ * Append the 32-bit little-endian +value+ to +buffer+.
+ */
+static void
+rlink_dump_put_u32( VALUE buffer, unsigned long value )
+{
+	char bytes[4];
+
+	bytes[0] = (char)( value & 0xFF );
+	bytes[1] = (char)( (value >> 8) & 0xFF );
+	bytes[2] = (char)( (value >> 16) & 0xFF );
+	bytes[3] = (char)( (value >> 24) & 0xFF );
+
+	rb_str_cat( buffer, bytes, 4 );
+}
+
+
+/*
+ * Append the signed +value+ to +buffer+ as a 32-bit two's-complement integer.
+ */
+static void
+rlink_dump_put_i32( VALUE buffer, long value )
+{
+	rlink_dump_put_u32( buffer, (unsigned long)value & 0xFFFFFFFFUL );
+}
+
+
+/*
+ * Append the string +str+ (which may be NULL) to +buffer+.
+ */
+static void
+rlink_dump_put_str( VALUE buffer, const char *str )
+{
+	size_t len;
+
+	if ( !str ) {
+		rlink_dump_put_u32( buffer, RLINK_DUMP_NIL );
+		return;
+	}
+
+	len = strlen( str );
+	rlink_dump_put_u32( buffer, len );
+	rb_str_cat( buffer, str, len );
+}
+
+
+/*
+ * Append the encoding of the given +linkage+ to +buffer+.
+ */
+static void
+rlink_dump_linkage( VALUE buffer, Linkage linkage )
+{
+	const char **words = linkage_get_words( linkage );
+	size_t num_words = linkage_get_num_words( linkage ),
+	       num_links = linkage_get_num_links( linkage ), i;
+
+	rlink_dump_put_i32( buffer, linkage_unused_word_cost(linkage) );
+	rlink_dump_put_i32( buffer, (long)linkage_disjunct_cost(linkage) );
+	rlink_dump_put_i32( buffer, linkage_link_cost(linkage) );
+	rlink_dump_put_str( buffer, linkage_get_violation_name(linkage) );
+
+	rlink_dump_put_u32( buffer, num_words );
+	for ( i = 0; i < num_words; i++ )
+		rlink_dump_put_str( buffer, words[i] );
+
+	rlink_dump_put_u32( buffer, num_links );
+	for ( i = 0; i < num_links; i++ ) {
+		rlink_dump_put_u32( buffer, linkage_get_link_lword(linkage, i) );
+		rlink_dump_put_u32( buffer, linkage_get_link_rword(linkage, i) );
+		rlink_dump_put_i32( buffer, linkage_get_link_length(linkage, i) );
+		rlink_dump_put_str( buffer, linkage_get_link_label(linkage, i) );
+		rlink_dump_put_str( buffer, linkage_get_link_llabel(linkage, i) );
+		rlink_dump_put_str( buffer, linkage_get_link_rlabel(linkage, i) );
+	}
+
+	for ( i = 0; i < num_words; i++ ) {
+#ifdef HAVE_LINKAGE_GET_DISJUNCT_STR
+		rlink_dump_put_str( buffer, linkage_get_disjunct_str(linkage, i) );
+#else
+		rlink_dump_put_str( buffer, linkage_get_disjunct(linkage, i) );
+#endif
+	}
+}
+
+
+/*
+ * Return a binary String containing the encoding of the results of parsing the
+ * given +sentence+ with +opts+, with its first +count+ linkages, recording +text+
+ * (a String or nil, already checked by the caller) as the text that was parsed. Doesn't call any Ruby
+ * code, so the sentence can't be released by another thread while it's running.
+ */
+VALUE
+rlink_dump_sentence( Sentence sentence, Parse_Options opts, int count, VALUE text )
+{
+	VALUE buffer = rb_str_buf_new( 256 );
+	int i;
+	const char version = RLINK_DUMP_VERSION;
+	long body_len;
+	char *len_ptr;
+
+	rb_str_cat( buffer, RLINK_DUMP_MAGIC, RLINK_DUMP_MAGIC_LEN );
+	rb_str_cat( buffer, &version, 1 );
+	rlink_dump_put_u32( buffer, 0 );
+
+	if ( NIL_P(text) ) {
+		rlink_dump_put_u32( buffer, RLINK_DUMP_NIL );
+	} else {
+		rlink_dump_put_u32( buffer, RSTRING_LEN(text) );
+		rb_str_cat( buffer, RSTRING_PTR(text), RSTRING_LEN(text) );
+	}
+	rlink_dump_put_u32( buffer, sentence_null_count(sentence) );
+	rlink_dump_put_u32( buffer, sentence_num_linkages_found(sentence) );
+	rlink_dump_put_u32( buffer, count );
+
+	for ( i = 0; i < count; i++ ) {
+		Linkage linkage = linkage_create( i, sentence, opts );
+		if ( !linkage ) rlink_raise_lp_error();
+
+		rlink_dump_linkage( buffer, linkage );
+		linkage_delete( linkage );
+	}
+
+	/* Now that the length of the body is known, fill it in */
+	body_len = RSTRING_LEN( buffer ) - RLINK_DUMP_HEADER_LEN;
+	len_ptr = RSTRING_PTR( buffer ) + RLINK_DUMP_MAGIC_LEN + 1;
+	len_ptr[0] = (char)( body_len & 0xFF );
+	len_ptr[1] = (char)( (body_len >> 8) & 0xFF );
+	len_ptr[2] = (char)( (body_len >> 16) & 0xFF );
+	len_ptr[3] = (char)( (body_len >> 24) & 0xFF );
+
+	return buffer;
+}
+
+
+/* --------------------------------------------------
+ * Reading
+ * -------------------------------------------------- */
+
+/*
+ * Raise a LinkParser::Error if the +reader+ doesn't have at least +len+ more
+ * bytes.
+ */
+static void
+rlink_dump_need( struct rlink_dump_reader *reader, unsigned long len )
+{
+	if ( (unsigned long)(reader->end - reader->pos) < len )
+		rb_raise( rlink_eLpError, "truncated LinkParser dump" );
+}
+
+
+/*
+ * Read an unsigned 32-bit little-endian integer from the +reader+.
+ */
+static unsigned long
+rlink_dump_get_u32( struct rlink_dump_reader *reader )
+{
+	const unsigned char *pos = reader->pos;
+
+	rlink_dump_need( reader, 4 );
+	reader->pos += 4;
+
+	return (unsigned long)pos[0] | ( (unsigned long)pos[1] << 8 ) |
+		( (unsigned long)pos[2] << 16 ) | ( (unsigned long)pos[3] << 24 );
+}
+
+
+/*
+ * Read a signed 32-bit little-endian integer from the +reader+.
+ */
+static long
+rlink_dump_get_i32( struct rlink_dump_reader *reader )
+{
+	unsigned long value = rlink_dump_get_u32( reader );
+
+	if ( value & 0x80000000UL ) return -(long)( (~value & 0xFFFFFFFFUL) + 1 );
+	return (long)value;
+}
+
+
+/*
+ * Read a string from the +reader+ and return it as a frozen String, or nil.
+ */
+static VALUE
+rlink_dump_get_str( struct rlink_dump_reader *reader )
+{
+	unsigned long len = rlink_dump_get_u32( reader );
+	VALUE str;
+
+	if ( len == RLINK_DUMP_NIL ) return Qnil;
+
+	rlink_dump_need( reader, len );
+	str = rb_str_new( (const char *)reader->pos, len );
+	reader->pos += len;
+
+	return rb_obj_freeze( str );
+}
+
+
+/*
+ * Read a word index from the +reader+, checking that it's less than +num_words+.
+ */
+static long
+rlink_dump_get_word_index( struct rlink_dump_reader *reader, long num_words )
+{
+	unsigned long index = rlink_dump_get_u32( reader );
+
+	if ( index >= (unsigned long)num_words )
+		rb_raise( rlink_eLpError, "invalid word index %lu in LinkParser dump", index );
+
+	return (long)index;
+}
+
+
+/*
+ * Read one linkage from the +reader+ and return it as a
+ * LinkParser::ParseResult::Linkage.
+ */
+static VALUE
+rlink_dump_load_linkage( struct rlink_dump_reader *reader )
+{
+	VALUE attrs = rb_hash_new();
+	VALUE words, links, disjunct_strings;
+	long num_words, num_links, i;
+
+	rb_hash_aset( attrs, unused_word_cost_sym, LONG2NUM(rlink_dump_get_i32(reader)) );
+	rb_hash_aset( attrs, disjunct_cost_sym, LONG2NUM(rlink_dump_get_i32(reader)) );
+	rb_hash_aset( attrs, link_cost_sym, LONG2NUM(rlink_dump_get_i32(reader)) );
+	rb_hash_aset( attrs, violation_name_sym, rlink_dump_get_str(reader) );
+
+	/* Each word takes at least 4 bytes, so a bogus count can't allocate much */
+	num_words = (long)rlink_dump_get_u32( reader );
+	rlink_dump_need( reader, (unsigned long)num_words * 4 );
+	words = rb_ary_new2( num_words );
+	for ( i = 0; i < num_words; i++ )
+		rb_ary_store( words, i, rlink_dump_get_str(reader) );
+	rb_obj_freeze( words );
+
+	if ( NIL_P(rlink_sLinkageLink) )
+		rlink_sLinkageLink = rb_const_get( rlink_cLinkage, rb_intern("Link") );
+
+	num_links = (long)rlink_dump_get_u32( reader );
+	rlink_dump_need( reader, (unsigned long)num_links * 24 );
+	links = rb_ary_new2( num_links );
+	for ( i = 0; i < num_links; i++ ) {
+		long lword  = rlink_dump_get_word_index( reader, num_words ),
+		     rword  = rlink_dump_get_word_index( reader, num_words ),
+		     length = rlink_dump_get_i32( reader );
+		VALUE label  = rlink_dump_get_str( reader ),
+		      llabel = rlink_dump_get_str( reader ),
+		      rlabel = rlink_dump_get_str( reader );
+
+		rb_ary_store( links, i, rb_obj_freeze(rb_struct_new(rlink_sLinkageLink,
+			RARRAY_AREF( words, lword ),
+			RARRAY_AREF( words, rword ),
+			LONG2FIX( length ),
+			label, llabel, rlabel,
+			rlink_linkage_link_desc( NIL_P(label) ? NULL : RSTRING_PTR(label) ))) );
+	}
+	rb_obj_freeze( links );
+
+	disjunct_strings = rb_ary_new2( num_words );
+	for ( i = 0; i < num_words; i++ )
+		rb_ary_store( disjunct_strings, i, rlink_dump_get_str(reader) );
+	rb_obj_freeze( disjunct_strings );
+
+	rb_hash_aset( attrs, words_sym, words );
+	rb_hash_aset( attrs, links_sym, links );
+	rb_hash_aset( attrs, disjunct_strings_sym, disjunct_strings );
+
+	return rlink_new_with_kwargs( rlink_cParseResultLinkage, attrs );
+}
+
+
+/*
+ *  call-seq:
+ *     LinkParser.load( data )   -> LinkParser::ParseResult
+ *
+ *  Load a LinkParser::ParseResult from +data+, a String created by
+ *  LinkParser::Sentence#dump (or LinkParser::DumpWriter). It has the same query
+ *  methods as the sentence it was dumped from, and doesn't need a Dictionary or
+ *  link-grammar itself. Raises a LinkParser::Error if +data+ isn't a dump, or
+ *  was written by a newer version of the binding.
+ *
+ *     result = LinkParser.load( sentence.dump )
+ *     result.subject   #-> "flag"
+ */
+static VALUE
+rlink_s_load( VALUE module, VALUE data )
+{
+	struct rlink_dump_reader reader;
+	VALUE attrs = rb_hash_new();
+	VALUE linkages;
+	unsigned long body_len;
+	long count, i;
+
+	StringValue( data );
+	data = rb_str_new_frozen( data );
+	reader.pos = (const unsigned char *)RSTRING_PTR( data );
+	reader.end = reader.pos + RSTRING_LEN( data );
+
+	rlink_dump_need( &reader, RLINK_DUMP_HEADER_LEN );
+	if ( memcmp(reader.pos, RLINK_DUMP_MAGIC, RLINK_DUMP_MAGIC_LEN) != 0 )
+		rb_raise( rlink_eLpError, "not a LinkParser dump" );
+	if ( reader.pos[RLINK_DUMP_MAGIC_LEN] != RLINK_DUMP_VERSION )
+		rb_raise( rlink_eLpError, "unsupported LinkParser dump version %d",
+			reader.pos[RLINK_DUMP_MAGIC_LEN] );
+	reader.pos += RLINK_DUMP_MAGIC_LEN + 1;
+
+	body_len = rlink_dump_get_u32( &reader );
+	rlink_dump_need( &reader, body_len );
+	if ( (unsigned long)(reader.end - reader.pos) > body_len )
+		rb_raise( rlink_eLpError, "trailing data after LinkParser dump" );
+
+	if ( NIL_P(rlink_cParseResult) ) {
+		rlink_cParseResult = rb_path2class( "LinkParser::ParseResult" );
+		rlink_cParseResultLinkage = rb_path2class( "LinkParser::ParseResult::Linkage" );
+	}
+
+	rb_hash_aset( attrs, text_sym, rlink_dump_get_str(&reader) );
+	rb_hash_aset( attrs, null_count_sym, ULONG2NUM(rlink_dump_get_u32(&reader)) );
+	rb_hash_aset( attrs, num_linkages_found_sym, ULONG2NUM(rlink_dump_get_u32(&reader)) );
+
+	count = (long)rlink_dump_get_u32( &reader );
+	rlink_dump_need( &reader, (unsigned long)count * 24 );
+	linkages = rb_ary_new2( count );
+	for ( i = 0; i < count; i++ )
+		rb_ary_store( linkages, i, rlink_dump_load_linkage(&reader) );
+	rb_hash_aset( attrs, linkages_sym, linkages );
+
+	if ( reader.pos != reader.end )
+		rb_raise( rlink_eLpError, "trailing data in LinkParser dump" );
+
+	RB_GC_GUARD( data );
+	return rlink_new_with_kwargs( rlink_cParseResult, attrs );
+}
+
+
+/*
+ *  call-seq:
+ *     LinkParser.dump_length( header )   -> integer
+ *
+ *  Return the total length in bytes of the dump that starts with +header+, which
+ *  must be at least LinkParser::DUMP_HEADER_LENGTH bytes long. Used to read
+ *  streams of dumps.
+ */
+static VALUE
+rlink_s_dump_length( VALUE module, VALUE header )
+{
+	struct rlink_dump_reader reader;
+
+	StringValue( header );
+	reader.pos = (const unsigned char *)RSTRING_PTR( header );
+	reader.end = reader.pos + RSTRING_LEN( header );
+
+	rlink_dump_need( &reader, RLINK_DUMP_HEADER_LEN );
+	if ( memcmp(reader.pos, RLINK_DUMP_MAGIC, RLINK_DUMP_MAGIC_LEN) != 0 )
+		rb_raise( rlink_eLpError, "not a LinkParser dump" );
+	reader.pos += RLINK_DUMP_MAGIC_LEN + 1;
+
+	return ULONG2NUM( RLINK_DUMP_HEADER_LEN + rlink_dump_get_u32(&reader) );
+}
+
+
+/*
+ * Set up the LinkParser.load function and friends.
+ */
+void
+rlink_init_dump()
+{
+	words_sym              = ID2SYM( rb_intern("words") );
+	links_sym              = ID2SYM( rb_intern("links") );
+	disjunct_strings_sym   = ID2SYM( rb_intern("disjunct_strings") );
+	unused_word_cost_sym   = ID2SYM( rb_intern("unused_word_cost") );
+	disjunct_cost_sym      = ID2SYM( rb_intern("disjunct_cost") );
+	link_cost_sym          = ID2SYM( rb_intern("link_cost") );
+	violation_name_sym     = ID2SYM( rb_intern("violation_name") );
+	text_sym               = ID2SYM( rb_intern("text") );
+	null_count_sym         = ID2SYM( rb_intern("null_count") );
+	num_linkages_found_sym = ID2SYM( rb_intern("num_linkages_found") );
+	linkages_sym           = ID2SYM( rb_intern("linkages") );
+
+	/* The version of the binary encoding written by LinkParser::Sentence#dump */
+	rb_define_const( rlink_mLinkParser, "DUMP_VERSION", INT2FIX(RLINK_DUMP_VERSION) );
+
+	/* The number of bytes at the start of a dump needed to tell its length */
+	rb_define_const( rlink_mLinkParser, "DUMP_HEADER_LENGTH", INT2FIX(RLINK_DUMP_HEADER_LEN) );
+
+	rb_define_singleton_method( rlink_mLinkParser, "load", rlink_s_load, 1 );
+	rb_define_singleton_method( rlink_mLinkParser, "dump_length", rlink_s_dump_length, 1 );
+}
+
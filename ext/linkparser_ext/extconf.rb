@@ -40,6 +40,20 @@ have_func( 'linkgrammar_get_configuration' )
 
 have_const( 'CORPUS' )
 
+unless enable_config( 'debug-logging', true )
+	$stderr.puts "Compiling without debug logging."
+	$defs << '-DRLINK_DISABLE_DEBUG_LOGGING'
+end
+
+have_header( 'ruby/thread.h' )
+have_func( 'rb_thread_call_without_gvl', 'ruby/thread.h' )
+have_func( 'rb_class_new_instance_kw' )
+have_func( 'rb_gc_adjust_memory_usage' )
+have_func( 'sentence_split', 'link-grammar/link-includes.h' )
+have_func( 'clock_gettime', 'time.h' )
+have_header( 'pthread.h' )
+have_header( 'unistd.h' )
+
 create_header()
 create_makefile( 'linkparser_ext' )
 
@@ -20,6 +20,30 @@ VALUE display_walls_sym;
 VALUE display_header_sym;
 VALUE max_width_sym;
 
+static VALUE words_sym;
+static VALUE links_sym;
+static VALUE disjunct_strings_sym;
+static VALUE unused_word_cost_sym;
+static VALUE disjunct_cost_sym;
+static VALUE link_cost_sym;
+static VALUE violation_name_sym;
+
+static VALUE offsets_sym;
+static VALUE lword_sym;
+static VALUE rword_sym;
+static VALUE length_sym;
+static VALUE label_sym;
+static VALUE labels_sym;
+
+/* The maximum number of characters of a link label used to look up its type */
+#define RLINK_MAX_LINK_TYPE_LEN 16
+
+/* Linkage::LINK_TYPES, looked up the first time it's needed */
+static VALUE rlink_link_types = Qnil;
+
+/* Freed rlink_linkage structs kept for re-use */
+static struct rlink_pool rlink_linkage_pool = RLINK_POOL_INIT( struct rlink_linkage, 1024 );
+
 
 /* --------------------------------------------------
  *	Memory-management functions
@@ -30,10 +54,14 @@ VALUE max_width_sym;
 static struct rlink_linkage *
 rlink_linkage_alloc()
 {
-	struct rlink_linkage *ptr = ALLOC( struct rlink_linkage );
+	struct rlink_linkage *ptr = rlink_pool_alloc( &rlink_linkage_pool );
 
 	ptr->linkage	= NULL;
 	ptr->sentence	= Qnil;
+	ptr->generation	= 0;
+	ptr->words		= Qnil;
+	ptr->links		= Qnil;
+	ptr->disjunct_strings = Qnil;
 
 	rlink_log( "debug", "Initialized an rlink_LINKAGE <%p>", ptr );
 	return ptr;
@@ -48,6 +76,9 @@ rlink_linkage_gc_mark( struct rlink_linkage *ptr )
 {
 	if ( ptr ) {
 		rb_gc_mark( ptr->sentence );
+		rb_gc_mark( ptr->words );
+		rb_gc_mark( ptr->links );
+		rb_gc_mark( ptr->disjunct_strings );
 	}
 }
 
@@ -59,30 +90,52 @@ static void
 rlink_linkage_gc_free( struct rlink_linkage *ptr )
 {
 	if ( ptr ) {
-		linkage_delete( (Linkage)ptr->linkage );
+		if ( ptr->linkage )
+			linkage_delete( (Linkage)ptr->linkage );
 		ptr->linkage = NULL;
 		ptr->sentence = Qnil;
 
-		xfree( ptr );
+		rlink_pool_free( &rlink_linkage_pool, ptr );
 		ptr = NULL;
 	}
 }
 
 
+/*
+ * GC Size function
+ */
+static size_t
+rlink_linkage_memsize( const struct rlink_linkage *ptr )
+{
+	return ptr ? sizeof( struct rlink_linkage ) : 0;
+}
+
+
+static const rb_data_type_t rlink_linkage_type = {
+	"LinkParser::Linkage",
+	{
+		(RUBY_DATA_FUNC)rlink_linkage_gc_mark,
+		(RUBY_DATA_FUNC)rlink_linkage_gc_free,
+		(size_t (*)(const void *))rlink_linkage_memsize,
+	},
+	0,
+	0,
+	RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+
 /*
  * Object validity checker. Returns the data pointer.
  */
 static struct rlink_linkage *
 check_linkage( VALUE self )
 {
-	Check_Type( self, T_DATA );
-
-    if ( !IsLinkage(self) ) {
+    if ( !rb_typeddata_is_kind_of(self, &rlink_linkage_type) ) {
 		rb_raise( rb_eTypeError, "wrong argument type %s (expected LinkParser::Linkage)",
 				  rb_class2name(CLASS_OF( self )) );
     }
 
-	return DATA_PTR( self );
+	return RTYPEDDATA_DATA( self );
 }
 
 
@@ -93,10 +146,22 @@ static struct rlink_linkage *
 get_linkage(  VALUE self )
 {
 	struct rlink_linkage *ptr = check_linkage( self );
+	struct rlink_sentence *sent_ptr;
 
 	if ( !ptr )
 		rb_raise( rb_eRuntimeError, "uninitialized Linkage" );
 
+	/* The link-grammar Linkage belongs to the Sentence, so it goes away with it */
+	sent_ptr = (struct rlink_sentence *)DATA_PTR( ptr->sentence );
+	if ( !sent_ptr->sentence )
+		rb_raise( rlink_eLpError, "Linkage's sentence has been released" );
+	if ( sent_ptr->parsing )
+		rb_raise( rlink_eLpError, "Sentence is being parsed by another thread" );
+
+	/* ...and so does parsing the sentence again */
+	if ( ptr->generation != sent_ptr->generation || !ptr->linkage )
+		rb_raise( rlink_eLpError, "Linkage's sentence has been parsed again" );
+
 	return ptr;
 }
 
@@ -111,6 +176,25 @@ rlink_get_linkage( VALUE self )
 }
 
 
+/*
+ * Detach the given Linkage +self+ from its link-grammar linkage before the
+ * Sentence it belongs to frees it (by being parsed again or deleted). This
+ * doesn't free any memory itself; it just stops the Linkage from using it.
+ * Anything already extracted from it (its words, links, and disjunct strings)
+ * can still be used afterwards.
+ */
+void
+rlink_linkage_detach( VALUE self )
+{
+	struct rlink_linkage *ptr = check_linkage( self );
+
+	if ( ptr && ptr->linkage ) {
+		linkage_delete( (Linkage)ptr->linkage );
+		ptr->linkage = NULL;
+	}
+}
+
+
 
 /*
  *  call-seq:
@@ -122,7 +206,7 @@ static VALUE
 rlink_linkage_s_alloc(  VALUE klass )
 {
 	rlink_log( "debug", "Wrapping an uninitialized Linkage pointer." );
-	return Data_Wrap_Struct( klass, rlink_linkage_gc_mark, rlink_linkage_gc_free, 0 );
+	return TypedData_Wrap_Struct( klass, &rlink_linkage_type, 0 );
 }
 
 
@@ -148,6 +232,8 @@ rlink_linkage_init( argc, argv, self )
 		Linkage linkage;
 		Parse_Options opts;
 		struct rlink_linkage *ptr;
+		struct rlink_timer timer;
+		double duration, cpu_time;
 
 		i = rb_scan_args( argc, argv, "21", &index, &sentence, &options );
 
@@ -156,20 +242,38 @@ rlink_linkage_init( argc, argv, self )
 		opts = rlink_get_parseopts( options );
 
 		sent_ptr = (struct rlink_sentence *)rlink_get_sentence( sentence );
+		if ( !sent_ptr->sentence )
+			rb_raise( rlink_eLpError, "Sentence has been released" );
+		if ( sent_ptr->parsing )
+			rb_raise( rlink_eLpError, "Sentence is being parsed by another thread" );
 
 		link_index = NUM2INT(index);
-		max_index = sentence_num_valid_linkages((Sentence)sent_ptr->sentence) - 1;
+		max_index = rlink_sentence_linkage_count( sent_ptr ) - 1;
 		if ( link_index > max_index )
 			rb_raise( rlink_eLpError, "Invalid linkage %d (max is %d)",
 				link_index, max_index );
 
+		rlink_timer_start( &timer );
 		linkage = linkage_create( link_index, (Sentence)sent_ptr->sentence, opts );
+		rlink_timer_stop( &timer, &duration, &cpu_time );
 		if ( !linkage ) rlink_raise_lp_error();
 
 		DATA_PTR( self ) = ptr = rlink_linkage_alloc();
 
 		ptr->linkage = linkage;
 		ptr->sentence = sentence;
+		ptr->generation = sent_ptr->generation;
+
+		if ( rlink_subscribed(RLINK_EVENT_LINKAGE) ) {
+			VALUE payload = rb_hash_new();
+
+			rb_hash_aset( payload, ID2SYM(rb_intern("index")), INT2FIX(link_index) );
+			rb_hash_aset( payload, ID2SYM(rb_intern("num_words")),
+				INT2FIX(linkage_get_num_words(linkage)) );
+			rb_hash_aset( payload, ID2SYM(rb_intern("num_links")),
+				INT2FIX(linkage_get_num_links(linkage)) );
+			rlink_publish_event( "linkage", duration, payload );
+		}
 	}
 
 	else {
@@ -386,6 +490,7 @@ rlink_linkage_get_link_length( VALUE self, VALUE index )
  * link_label( index ) -> str
  * --
  * The "intersection" of the left and right connectors that comprise the link.
+ * Labels are frozen, and the same String is returned for the same label.
  */
 static VALUE
 rlink_linkage_get_link_label( VALUE self, VALUE index )
@@ -395,9 +500,8 @@ rlink_linkage_get_link_label( VALUE self, VALUE index )
 	const char *label;
 
 	label = linkage_get_link_label( (Linkage)ptr->linkage, i );
-	if ( !label ) return Qnil;
 
-	return rb_str_new2( label );
+	return rlink_interned_str( label );
 }
 
 
@@ -405,6 +509,7 @@ rlink_linkage_get_link_label( VALUE self, VALUE index )
  * link_llabel -> str
  * --
  * The label on the left word of the index-th link of the current sublinkage.
+ * Labels are frozen, and the same String is returned for the same label.
  */
 static VALUE
 rlink_linkage_get_link_llabel( VALUE self, VALUE index )
@@ -414,15 +519,15 @@ rlink_linkage_get_link_llabel( VALUE self, VALUE index )
 	const char *label = NULL;
 
 	label = linkage_get_link_llabel( (Linkage)ptr->linkage, i );
-	if ( !label ) return Qnil;
 
-	return rb_str_new2( label );
+	return rlink_interned_str( label );
 }
 
 /*
  * link_rlabel -> str
  * --
  * The label on the right word of the index-th link of the current sublinkage.
+ * Labels are frozen, and the same String is returned for the same label.
  */
 static VALUE
 rlink_linkage_get_link_rlabel( VALUE self, VALUE index )
@@ -432,51 +537,69 @@ rlink_linkage_get_link_rlabel( VALUE self, VALUE index )
 	const char *label = NULL;
 
 	label = linkage_get_link_rlabel( (Linkage)ptr->linkage, i );
-	if ( !label ) return Qnil;
 
-	return rb_str_new2( label );
+	return rlink_interned_str( label );
 }
 
 
 /*
- *  disjunct_strings -> array
- *
- *  Return an Array of Strings showing the disjuncts that were actually used in association
- *  with each corresponding word in the current linkage. Each string shows the disjuncts
- *  in proper order; that is, left-to-right, in the order in which they link to other words.
- *  The returned strings can be thought of as a very precise part-of-speech-like label for
- *  each word, indicating how it was used in the given sentence; this can be useful
- *  for corpus statistics.
- *
- *  For a parsed version of the disjunct strings, call #disjuncts instead.
- *
+ * Return a new frozen Array of the frozen disjunct strings of the given +linkage+.
  */
 static VALUE
-rlink_linkage_get_disjunct_strings( VALUE self )
+rlink_linkage_make_disjunct_strings( Linkage linkage )
 {
-	struct rlink_linkage *ptr = get_linkage( self );
 	const char *disjunct;
 	unsigned long i, count = 0l;
 	VALUE disjuncts_ary;
 
-	count = linkage_get_num_words( (Linkage)ptr->linkage );
+	count = linkage_get_num_words( linkage );
 	disjuncts_ary = rb_ary_new2( count );
 
 	for ( i = 0; i < count; i++ ) {
 #ifdef HAVE_LINKAGE_GET_DISJUNCT_STR
-		disjunct = linkage_get_disjunct_str( (Linkage)ptr->linkage, i );
+		disjunct = linkage_get_disjunct_str( linkage, i );
 #else
-		disjunct = linkage_get_disjunct( (Linkage)ptr->linkage, i );
+		disjunct = linkage_get_disjunct( linkage, i );
 #endif
 		if ( disjunct ) {
-			rb_ary_store( disjuncts_ary, i, rb_str_new2(disjunct) );
+			rb_ary_store( disjuncts_ary, i, rb_obj_freeze(rb_str_new2(disjunct)) );
 
 		} else {
 			rb_ary_store( disjuncts_ary, i, Qnil );
 		}
 	}
 
-	return disjuncts_ary;
+	return rb_obj_freeze( disjuncts_ary );
+}
+
+
+/*
+ *  disjunct_strings -> array
+ *
+ *  Return an Array of Strings showing the disjuncts that were actually used in association
+ *  with each corresponding word in the current linkage. Each string shows the disjuncts
+ *  in proper order; that is, left-to-right, in the order in which they link to other words.
+ *  The returned strings can be thought of as a very precise part-of-speech-like label for
+ *  each word, indicating how it was used in the given sentence; this can be useful
+ *  for corpus statistics.
+ *
+ *  For a parsed version of the disjunct strings, call #disjuncts instead.
+ *
+ *  The Array and its Strings are frozen, and the same Array is returned by every
+ *  call, even after the sentence has been released.
+ */
+static VALUE
+rlink_linkage_get_disjunct_strings( VALUE self )
+{
+	struct rlink_linkage *ptr = check_linkage( self );
+
+	if ( ptr && !NIL_P(ptr->disjunct_strings) ) return ptr->disjunct_strings;
+
+	ptr = get_linkage( self );
+	if ( NIL_P(ptr->disjunct_strings) )
+		ptr->disjunct_strings = rlink_linkage_make_disjunct_strings( (Linkage)ptr->linkage );
+
+	return ptr->disjunct_strings;
 }
 
 
@@ -521,13 +644,49 @@ rlink_linkage_get_link_domain_names( VALUE self, VALUE index )
 	names_ary = rb_ary_new2( count );
 
 	for ( i = 0; i < count; i++ ) {
-		rb_ary_store( names_ary, i, rb_str_new2(names[i]) );
+		rb_ary_store( names_ary, i, rlink_interned_str(names[i]) );
 	}
 
 	return names_ary;
 }
 
 
+/*
+ * Return a new frozen Array of the frozen words of the given +linkage+.
+ */
+static VALUE
+rlink_linkage_make_words( Linkage linkage )
+{
+	const char **words;
+	unsigned long count, i;
+	VALUE words_ary;
+
+	count = linkage_get_num_words( linkage );
+	words = linkage_get_words( linkage );
+	words_ary = rb_ary_new2( count );
+
+	for ( i = 0; i < count; i++ ) {
+		rb_ary_store( words_ary, i, rlink_interned_str(words[i]) );
+	}
+
+	return rb_obj_freeze( words_ary );
+}
+
+
+/*
+ * Return the frozen Array of frozen words of the linkage pointed to by +ptr+,
+ * fetching them the first time.
+ */
+static VALUE
+rlink_linkage_words( struct rlink_linkage *ptr )
+{
+	if ( NIL_P(ptr->words) )
+		ptr->words = rlink_linkage_make_words( (Linkage)ptr->linkage );
+
+	return ptr->words;
+}
+
+
 /*
  *  call-seq:
  *     words   -> array
@@ -535,24 +694,169 @@ rlink_linkage_get_link_domain_names( VALUE self, VALUE index )
  *  Return the Array of word spellings or individual word spelling for the
  *  current sublinkage. These are the "inflected" spellings, such as "dog.n".
  *  The original spellings can be obtained by calls to Sentence#words.
+ *
+ *  The Array and its Strings are frozen, and the same Array is returned by every
+ *  call, even after the sentence has been released.
  */
 static VALUE
 rlink_linkage_get_words( VALUE self )
 {
-	struct rlink_linkage *ptr = get_linkage( self );
-	const char **words;
-	unsigned long count, i;
-	VALUE words_ary;
+	struct rlink_linkage *ptr = check_linkage( self );
+
+	if ( ptr && !NIL_P(ptr->words) ) return ptr->words;
+	return rlink_linkage_words( get_linkage(self) );
+}
+
+
+/*
+ * Look up the description of the link type of the given +label+ in LINK_TYPES. The
+ * type is the uppercase part of the label, e.g., 'Ss' for 'Ss*s'.
+ */
+VALUE
+rlink_linkage_link_desc( const char *label )
+{
+	char type[ RLINK_MAX_LINK_TYPE_LEN + 1 ];
+	size_t len = 0;
+
+	if ( !label ) return Qnil;
+
+	if ( NIL_P(rlink_link_types) )
+		rlink_link_types = rb_const_get( rlink_cLinkage, rb_intern("LINK_TYPES") );
+
+	for ( ; *label && len < RLINK_MAX_LINK_TYPE_LEN; label++ ) {
+		if ( *label >= 'A' && *label <= 'Z' ) type[ len++ ] = *label;
+	}
+	type[ len ] = '\0';
+
+	return rb_hash_lookup( rlink_link_types, rlink_interned_str(type) );
+}
 
-	count = linkage_get_num_words( (Linkage)ptr->linkage );
-	words = linkage_get_words( (Linkage)ptr->linkage );
-	words_ary = rb_ary_new2( count );
+
+/*
+ * Build a frozen LinkParser::Linkage::Link for the link at +index+ in the given
+ * +linkage+, taking its words from +words+ (an Array from rlink_linkage_words()).
+ */
+static VALUE
+rlink_linkage_make_link( Linkage linkage, LinkIdx index, VALUE words )
+{
+	const char *label  = linkage_get_link_label( linkage, index ),
+	           *llabel = linkage_get_link_llabel( linkage, index ),
+	           *rlabel = linkage_get_link_rlabel( linkage, index );
+
+	if ( NIL_P(rlink_sLinkageLink) )
+		rlink_sLinkageLink = rb_const_get( rlink_cLinkage, rb_intern("Link") );
+
+	return rb_obj_freeze( rb_struct_new(rlink_sLinkageLink,
+		rb_ary_entry( words, linkage_get_link_lword(linkage, index) ),
+		rb_ary_entry( words, linkage_get_link_rword(linkage, index) ),
+		INT2FIX( linkage_get_link_length(linkage, index) ),
+		rlink_interned_str( label ),
+		rlink_interned_str( llabel ),
+		rlink_interned_str( rlabel ),
+		rlink_linkage_link_desc( label )) );
+}
+
+
+/*
+ * Return a new frozen Array of LinkParser::Linkage::Links for all the links of the
+ * given +linkage+, taking their words from +words+.
+ */
+static VALUE
+rlink_linkage_make_links( Linkage linkage, VALUE words )
+{
+	size_t count = linkage_get_num_links( linkage ), i;
+	VALUE links_ary = rb_ary_new2( count );
 
 	for ( i = 0; i < count; i++ ) {
-		rb_ary_store( words_ary, i, rb_str_new2(words[i]) );
+		rb_ary_store( links_ary, i, rlink_linkage_make_link(linkage, i, words) );
 	}
 
-	return words_ary;
+	return rb_obj_freeze( links_ary );
+}
+
+
+/*
+ *  call-seq:
+ *     links   -> array
+ *
+ *  Return an Array of LinkParser::Linkage::Link structs, one for each link in the
+ *  linkage. The Array and the Links are frozen, and the same Array is returned by
+ *  every call, even after the sentence has been released.
+ */
+static VALUE
+rlink_linkage_get_links( VALUE self )
+{
+	struct rlink_linkage *ptr = check_linkage( self );
+
+	if ( ptr && !NIL_P(ptr->links) ) return ptr->links;
+
+	ptr = get_linkage( self );
+	if ( NIL_P(ptr->links) )
+		ptr->links = rlink_linkage_make_links( (Linkage)ptr->linkage, rlink_linkage_words(ptr) );
+
+	return ptr->links;
+}
+
+
+/*
+ *  call-seq:
+ *     each_link {|link| ... }   -> linkage
+ *     each_link                 -> enumerator
+ *
+ *  Yield a LinkParser::Linkage::Link struct for each link in the linkage. Unless
+ *  #links has already been called, they're built one at a time instead of as an
+ *  Array. Returns an Enumerator if called without a block.
+ */
+static VALUE
+rlink_linkage_each_link( VALUE self )
+{
+	struct rlink_linkage *ptr;
+	long i;
+	VALUE words;
+
+	RETURN_ENUMERATOR( self, 0, 0 );
+
+	ptr = check_linkage( self );
+	if ( ptr && !NIL_P(ptr->links) ) {
+		for ( i = 0; i < RARRAY_LEN(ptr->links); i++ )
+			rb_yield( RARRAY_AREF(ptr->links, i) );
+		return self;
+	}
+
+	ptr = get_linkage( self );
+	words = rlink_linkage_words( ptr );
+
+	/* Re-fetch the linkage each time, since the block could release the sentence */
+	for ( i = 0; i < (long)linkage_get_num_links((Linkage)ptr->linkage); i++ ) {
+		rb_yield( rlink_linkage_make_link((Linkage)ptr->linkage, i, words) );
+		ptr = get_linkage( self );
+	}
+
+	return self;
+}
+
+
+/*
+ *  call-seq:
+ *     link( index )   -> LinkParser::Linkage::Link
+ *
+ *  Return the +index+th link of the linkage as a LinkParser::Linkage::Link struct.
+ *  Raises an IndexError if there's no such link.
+ */
+static VALUE
+rlink_linkage_get_link( VALUE self, VALUE index )
+{
+	struct rlink_linkage *ptr = get_linkage( self );
+	Linkage linkage = (Linkage)ptr->linkage;
+	long count = linkage_get_num_links( linkage ),
+	     i = NUM2LONG( index );
+
+	if ( i < 0 || i >= count )
+		rb_raise( rb_eIndexError, "link %ld out of range (linkage has %ld links)", i, count );
+
+	if ( !NIL_P(ptr->links) ) return RARRAY_AREF( ptr->links, i );
+
+	return rlink_linkage_make_link( linkage, (LinkIdx)i, rlink_linkage_words(ptr) );
 }
 
 
@@ -639,6 +943,274 @@ rlink_linkage_get_violation_name( VALUE self )
 }
 
 
+/*
+ * Return a Hash of the attributes of a LinkParser::ParseResult::Linkage with the
+ * given +words+, +links+ and +disjunct_strings+ and the costs of +linkage+.
+ */
+static VALUE
+rlink_linkage_make_result_attrs( Linkage linkage, VALUE words, VALUE links,
+	VALUE disjunct_strings )
+{
+	const char *violation_name = linkage_get_violation_name( linkage );
+	VALUE attrs = rb_hash_new();
+
+	rb_hash_aset( attrs, words_sym, words );
+	rb_hash_aset( attrs, links_sym, links );
+	rb_hash_aset( attrs, disjunct_strings_sym, disjunct_strings );
+	rb_hash_aset( attrs, unused_word_cost_sym, INT2FIX(linkage_unused_word_cost(linkage)) );
+	rb_hash_aset( attrs, disjunct_cost_sym, INT2FIX((int)linkage_disjunct_cost(linkage)) );
+	rb_hash_aset( attrs, link_cost_sym, INT2FIX(linkage_link_cost(linkage)) );
+	rb_hash_aset( attrs, violation_name_sym,
+		violation_name ? rb_obj_freeze(rb_str_new2(violation_name)) : Qnil );
+
+	return attrs;
+}
+
+
+/*
+ * Return a Hash of the attributes of a LinkParser::ParseResult::Linkage for the
+ * given +linkage+. Doesn't call any Ruby code, so the caller can be sure the
+ * linkage's sentence isn't released by another thread while it's running.
+ */
+VALUE
+rlink_linkage_result_attrs( Linkage linkage )
+{
+	VALUE words = rlink_linkage_make_words( linkage );
+
+	return rlink_linkage_make_result_attrs( linkage, words,
+		rlink_linkage_make_links(linkage, words), rlink_linkage_make_disjunct_strings(linkage) );
+}
+
+
+/*
+ *  call-seq:
+ *     linkage.to_result   -> LinkParser::ParseResult::Linkage
+ *
+ *  Return a frozen copy of the linkage's words, links, disjuncts and costs that
+ *  doesn't refer to the linkage or its LinkParser::Sentence, so it can be kept
+ *  after they're released or collected.
+ */
+static VALUE
+rlink_linkage_to_result( VALUE self )
+{
+	struct rlink_linkage *ptr = get_linkage( self );
+	VALUE attrs;
+
+	attrs = rlink_linkage_make_result_attrs( (Linkage)ptr->linkage, rlink_linkage_words(ptr),
+		rlink_linkage_get_links(self), rlink_linkage_get_disjunct_strings(self) );
+
+	if ( NIL_P(rlink_cParseResultLinkage) )
+		rlink_cParseResultLinkage = rb_path2class( "LinkParser::ParseResult::Linkage" );
+
+	return rlink_new_with_kwargs( rlink_cParseResultLinkage, attrs );
+}
+
+
+/*
+ * Return a new binary String big enough for +count+ int32_t values.
+ */
+static VALUE
+rlink_linkage_int32_buffer( long count )
+{
+	return rb_str_new( NULL, count * (long)sizeof(int32_t) );
+}
+
+
+/* The state of a Linkage.pack_links call */
+struct rlink_pack_call {
+	VALUE		linkages;
+	VALUE		labels;
+	long		count;
+	long		next_id;
+	st_table	*seen;
+	int32_t		*offset_col, *lword_col, *rword_col, *length_col, *label_col;
+};
+
+
+/*
+ * Return the id of +label+ in the labels Hash of the given +call+, adding it with
+ * the next unused id if it isn't there yet. The ids of labels seen in this call are
+ * kept in its +seen+ table so each distinct label only has to be looked up in the
+ * Hash once.
+ */
+static int32_t
+rlink_linkage_label_id( const char *label, struct rlink_pack_call *call )
+{
+	st_data_t id;
+	VALUE label_str, existing;
+
+	if ( !label ) return -1;
+	if ( st_lookup(call->seen, (st_data_t)label, &id) ) return (int32_t)id;
+
+	label_str = rlink_interned_str( label );
+	existing = rb_hash_lookup2( call->labels, label_str, Qundef );
+	if ( existing == Qundef ) {
+		if ( call->next_id > INT32_MAX )
+			rb_raise( rb_eRangeError, "no more label ids left to assign" );
+		id = (st_data_t)call->next_id++;
+		rb_hash_aset( call->labels, label_str, LONG2FIX((long)id) );
+	} else {
+		id = (st_data_t)NUM2INT( existing );
+	}
+
+	st_insert( call->seen, (st_data_t)label, id );
+	return (int32_t)id;
+}
+
+
+/*
+ * Check that one of the ids in the labels Hash given to pack_links is a
+ * non-negative Integer that fits in a column, and note the next unused id in the
+ * rlink_pack_call at +data+ (rb_hash_foreach callback).
+ */
+static int
+rlink_linkage_check_label_id( VALUE label, VALUE id, VALUE data )
+{
+	struct rlink_pack_call *call = (struct rlink_pack_call *)data;
+	int value;
+
+	if ( !RB_INTEGER_TYPE_P(id) )
+		rb_raise( rb_eTypeError, "label ids must be Integers, not %s", rb_obj_classname(id) );
+	if ( (value = NUM2INT(id)) < 0 )
+		rb_raise( rb_eRangeError, "label ids can't be negative (got %d)", value );
+	if ( value >= call->next_id )
+		call->next_id = (long)value + 1;
+
+	return ST_CONTINUE;
+}
+
+
+/*
+ * Write the links of the linkages of the given rlink_pack_call into its columns
+ * (rb_ensure body). Nothing in here can switch threads, so the sentences can't be
+ * released out from under it.
+ */
+static VALUE
+rlink_linkage_pack_columns( VALUE data )
+{
+	struct rlink_pack_call *call = (struct rlink_pack_call *)data;
+	long i, row = 0;
+
+	for ( i = 0; i < call->count; i++ ) {
+		Linkage linkage = (Linkage)( (struct rlink_linkage *)DATA_PTR(RARRAY_AREF(call->linkages, i)) )->linkage;
+		LinkIdx link, num_links = linkage_get_num_links( linkage );
+
+		call->offset_col[ i ] = (int32_t)row;
+		for ( link = 0; link < num_links; link++, row++ ) {
+			call->lword_col[ row ]  = (int32_t)linkage_get_link_lword( linkage, link );
+			call->rword_col[ row ]  = (int32_t)linkage_get_link_rword( linkage, link );
+			call->length_col[ row ] = (int32_t)linkage_get_link_length( linkage, link );
+			call->label_col[ row ]  = rlink_linkage_label_id(
+				linkage_get_link_label(linkage, link), call );
+		}
+	}
+	call->offset_col[ call->count ] = (int32_t)row;
+
+	return Qnil;
+}
+
+
+/*
+ * Free the table of labels seen by the given rlink_pack_call (rb_ensure ensure).
+ */
+static VALUE
+rlink_linkage_pack_finish( VALUE data )
+{
+	struct rlink_pack_call *call = (struct rlink_pack_call *)data;
+
+	st_free_table( call->seen );
+	call->seen = NULL;
+
+	return Qnil;
+}
+
+
+/*
+ *  call-seq:
+ *     LinkParser::Linkage.pack_links( linkages, labels={} )   -> hash
+ *
+ *  Write the link tables of all the given +linkages+ into packed columns of
+ *  native-endian 32-bit integers (i.e., <tt>unpack("l*")</tt>, or numpy's +int32+)
+ *  without creating any LinkParser::Linkage::Link objects. Returns a Hash of
+ *  binary Strings:
+ *
+ *  [:lword, :rword, :length]
+ *    the left and right word indexes and the length of each link
+ *  [:label]
+ *    the id of each link's label in +labels+, or -1 if it doesn't have one
+ *  [:offsets]
+ *    the index of the first link of each linkage in the other columns, followed
+ *    by the total number of links
+ *
+ *  and <tt>:labels</tt>, the Hash of label Strings to ids. Labels that aren't
+ *  already in +labels+ are added to it with ids after the highest one already
+ *  there, so passing the same Hash for every batch keeps the ids the same across
+ *  all of them. Its ids have to be non-negative Integers.
+ *
+ *     labels = {}
+ *     columns = LinkParser::Linkage.pack_links( sentence.linkages.to_a, labels )
+ *     columns[:lword].unpack( "l*" )   # => [0, 0, 1, 2, 3, 3, 4]
+ *     labels                           # => {"Wd"=>0, "Ss*s"=>1, "D*u"=>2, ...}
+ */
+static VALUE
+rlink_linkage_s_pack_links( int argc, VALUE *argv, VALUE klass )
+{
+	VALUE linkages, labels, columns;
+	VALUE offsets, lwords, rwords, lengths, label_ids;
+	struct rlink_pack_call call;
+	long total = 0, i;
+
+	rb_scan_args( argc, argv, "11", &linkages, &labels );
+
+	linkages = rb_Array( linkages );
+	if ( NIL_P(labels) ) labels = rb_hash_new();
+	Check_Type( labels, T_HASH );
+	rb_check_frozen( labels );
+
+	/* Check the existing ids now, so looking them up while packing can't raise */
+	call.next_id = 0;
+	rb_hash_foreach( labels, rlink_linkage_check_label_id, (VALUE)&call );
+
+	/* Check all the linkages and count their links before writing anything */
+	call.count = RARRAY_LEN( linkages );
+	for ( i = 0; i < call.count; i++ ) {
+		struct rlink_linkage *ptr = get_linkage( RARRAY_AREF(linkages, i) );
+		total += linkage_get_num_links( (Linkage)ptr->linkage );
+	}
+	if ( total > INT32_MAX )
+		rb_raise( rb_eRangeError, "too many links to pack (%ld)", total );
+
+	offsets   = rlink_linkage_int32_buffer( call.count + 1 );
+	lwords    = rlink_linkage_int32_buffer( total );
+	rwords    = rlink_linkage_int32_buffer( total );
+	lengths   = rlink_linkage_int32_buffer( total );
+	label_ids = rlink_linkage_int32_buffer( total );
+
+	call.linkages   = linkages;
+	call.labels     = labels;
+	call.offset_col = (int32_t *)RSTRING_PTR( offsets );
+	call.lword_col  = (int32_t *)RSTRING_PTR( lwords );
+	call.rword_col  = (int32_t *)RSTRING_PTR( rwords );
+	call.length_col = (int32_t *)RSTRING_PTR( lengths );
+	call.label_col  = (int32_t *)RSTRING_PTR( label_ids );
+
+	/* Adding labels can still run out of memory, so make sure the table is freed */
+	call.seen = st_init_strtable();
+	rb_ensure( rlink_linkage_pack_columns, (VALUE)&call, rlink_linkage_pack_finish, (VALUE)&call );
+	RB_GC_GUARD( linkages );
+
+	columns = rb_hash_new();
+	rb_hash_aset( columns, offsets_sym, offsets );
+	rb_hash_aset( columns, lword_sym, lwords );
+	rb_hash_aset( columns, rword_sym, rwords );
+	rb_hash_aset( columns, length_sym, lengths );
+	rb_hash_aset( columns, label_sym, label_ids );
+	rb_hash_aset( columns, labels_sym, labels );
+
+	return columns;
+}
+
+
 /*
  * Document-class: LinkParser::Linkage
  *
@@ -659,8 +1231,28 @@ rlink_init_linkage()
 	display_header_sym = ID2SYM( rb_intern("display_header") );
 	max_width_sym      = ID2SYM( rb_intern("max_width") );
 
+	words_sym            = ID2SYM( rb_intern("words") );
+	links_sym            = ID2SYM( rb_intern("links") );
+	disjunct_strings_sym = ID2SYM( rb_intern("disjunct_strings") );
+	unused_word_cost_sym = ID2SYM( rb_intern("unused_word_cost") );
+	disjunct_cost_sym    = ID2SYM( rb_intern("disjunct_cost") );
+	link_cost_sym        = ID2SYM( rb_intern("link_cost") );
+	violation_name_sym   = ID2SYM( rb_intern("violation_name") );
+
+	offsets_sym = ID2SYM( rb_intern("offsets") );
+	lword_sym   = ID2SYM( rb_intern("lword") );
+	rword_sym   = ID2SYM( rb_intern("rword") );
+	length_sym  = ID2SYM( rb_intern("length") );
+	label_sym   = ID2SYM( rb_intern("label") );
+	labels_sym  = ID2SYM( rb_intern("labels") );
+
+	rb_gc_register_address( &rlink_sLinkageLink );
+	rb_gc_register_address( &rlink_link_types );
+
 	rb_define_alloc_func( rlink_cLinkage, rlink_linkage_s_alloc );
 
+	rb_define_singleton_method( rlink_cLinkage, "pack_links", rlink_linkage_s_pack_links, -1 );
+
 	rb_define_method( rlink_cLinkage, "initialize", rlink_linkage_init, -1 );
 	rb_define_method( rlink_cLinkage, "diagram", rlink_linkage_diagram, -1 );
 	rb_define_method( rlink_cLinkage, "postscript_diagram", rlink_linkage_print_postscript, -1 );
@@ -681,6 +1273,10 @@ rlink_init_linkage()
 	rb_define_method( rlink_cLinkage, "link_num_domains", rlink_linkage_get_link_num_domains, 1 );
 	rb_define_method( rlink_cLinkage, "link_domain_names", rlink_linkage_get_link_domain_names, 1 );
 
+	rb_define_method( rlink_cLinkage, "link", rlink_linkage_get_link, 1 );
+	rb_define_method( rlink_cLinkage, "links", rlink_linkage_get_links, 0 );
+	rb_define_method( rlink_cLinkage, "each_link", rlink_linkage_each_link, 0 );
+
 	rb_define_method( rlink_cLinkage, "words", rlink_linkage_get_words, 0 );
 	rb_define_method( rlink_cLinkage, "disjunct_strings", rlink_linkage_get_disjunct_strings, 0 );
 
@@ -688,5 +1284,7 @@ rlink_init_linkage()
 	rb_define_method( rlink_cLinkage, "disjunct_cost", rlink_linkage_disjunct_cost, 0 );
 	rb_define_method( rlink_cLinkage, "link_cost", rlink_linkage_link_cost, 0 );
 	rb_define_method( rlink_cLinkage, "violation_name", rlink_linkage_get_violation_name, 0 );
+
+	rb_define_method( rlink_cLinkage, "to_result", rlink_linkage_to_result, 0 );
 }
 
@@ -25,6 +25,24 @@ VALUE rlink_cLinkage;
 VALUE rlink_cParseOptions;
 
 VALUE rlink_sLinkageCTree;
+VALUE rlink_sLinkageLink = Qnil;
+VALUE rlink_cParseResult = Qnil;
+VALUE rlink_cParseResultLinkage = Qnil;
+
+/* The numeric level of the LinkParser logger (see rlink_log_enabled()) */
+int rlink_log_threshold = RLINK_LOG_DEBUG;
+
+/* The RLINK_EVENT_* flags of the events that have subscribers (see rlink_subscribed()) */
+int rlink_event_mask = 0;
+
+/* The most strings rlink_interned_str() will keep; past that it just returns new
+   frozen ones, so a stream of unique words can't grow the table forever */
+#define RLINK_MAX_INTERNED_STRINGS 65536
+
+/* The table of interned strings (see rlink_interned_str()), and the hidden object
+   that marks them and reports their size */
+static st_table *rlink_interned_strings;
+static VALUE rlink_interned_strings_holder = Qnil;
 
 
 /* --------------------------------------------------------------
@@ -32,13 +50,14 @@ VALUE rlink_sLinkageCTree;
  * -------------------------------------------------------------- */
 
 /*
- * Log a message to the given +context+ object's logger.
+ * Log a message to the given +context+ object's logger. Use rlink_log_obj() instead
+ * of calling this directly so the message is skipped if its level isn't enabled.
  */
 void
 #ifdef HAVE_STDARG_PROTOTYPES
-rlink_log_obj( VALUE context, const char *level, const char *fmt, ... )
+rlink_log_obj_message( VALUE context, const char *level, const char *fmt, ... )
 #else
-rlink_log_obj( VALUE context, const char *level, const char *fmt, va_dcl )
+rlink_log_obj_message( VALUE context, const char *level, const char *fmt, va_dcl )
 #endif
 {
 	char buf[BUFSIZ];
@@ -58,13 +77,14 @@ rlink_log_obj( VALUE context, const char *level, const char *fmt, va_dcl )
 
 
 /*
- * Log a message to the global logger.
+ * Log a message to the global logger. Use rlink_log() instead of calling this
+ * directly so the message is skipped if its level isn't enabled.
  */
 void
 #ifdef HAVE_STDARG_PROTOTYPES
-rlink_log( const char *level, const char *fmt, ... )
+rlink_log_message( const char *level, const char *fmt, ... )
 #else
-rlink_log( const char *level, const char *fmt, va_dcl )
+rlink_log_message( const char *level, const char *fmt, va_dcl )
 #endif
 {
 	char buf[BUFSIZ];
@@ -83,6 +103,116 @@ rlink_log( const char *level, const char *fmt, va_dcl )
 }
 
 
+/*
+ *  call-seq:
+ *     LinkParser.refresh_log_level   -> integer
+ *
+ *  Update the extension's cached copy of the LinkParser logger's level, which it
+ *  uses to skip formatting log messages that won't be written. This is called
+ *  whenever the logger or its level changes, so you shouldn't need to call it
+ *  yourself. Returns the numeric level.
+ *
+ */
+static VALUE
+rlink_s_refresh_log_level( VALUE module )
+{
+	VALUE logger, level;
+
+	if ( !rb_respond_to(module, rb_intern("logger")) ) return INT2FIX( rlink_log_threshold );
+
+	logger = rb_funcall( module, rb_intern("logger"), 0 );
+	level = rb_funcall( logger, rb_intern("level"), 0 );
+
+	/* Loggability loggers return their level as a Symbol */
+	if ( SYMBOL_P(level) ) level = rb_sym2str( level );
+	if ( RB_TYPE_P(level, T_STRING) ) {
+		rlink_log_threshold = RSTRING_LEN( level ) ? rlink_log_level( RSTRING_PTR(level) ) : RLINK_LOG_DEBUG;
+	} else {
+		rlink_log_threshold = NUM2INT( level );
+	}
+
+	return INT2FIX( rlink_log_threshold );
+}
+
+
+/*
+ *  call-seq:
+ *     LinkParser.refresh_subscriptions   -> integer
+ *
+ *  Update the extension's cached set of the events that have subscribers, which it
+ *  uses to skip building events nobody is listening for. This is called by
+ *  LinkParser.subscribe and LinkParser.unsubscribe, so you shouldn't need to call
+ *  it yourself. Returns the set as a bitmask.
+ *
+ */
+static VALUE
+rlink_s_refresh_subscriptions( VALUE module )
+{
+	VALUE events = rb_Array( rb_funcall(module, rb_intern("subscribed_events"), 0) );
+	int mask = 0;
+	long i;
+
+	for ( i = 0; i < RARRAY_LEN(events); i++ ) {
+		ID event = rb_to_id( RARRAY_AREF(events, i) );
+
+		if ( event == rb_intern("dictionary_load") ) mask |= RLINK_EVENT_DICTIONARY_LOAD;
+		else if ( event == rb_intern("parse") ) mask |= RLINK_EVENT_PARSE;
+		else if ( event == rb_intern("linkage") ) mask |= RLINK_EVENT_LINKAGE;
+	}
+
+	rlink_event_mask = mask;
+	return INT2FIX( mask );
+}
+
+
+/*
+ * Publish the event called +name+ that took +duration+ seconds to the subscribers
+ * to it, with the given +payload+ Hash. Check rlink_subscribed() first so the
+ * payload isn't built if there aren't any.
+ */
+void
+rlink_publish_event( const char *name, double duration, VALUE payload )
+{
+	rb_funcall( rlink_mLinkParser, rb_intern("publish_event"), 3,
+		ID2SYM(rb_intern(name)), rb_float_new(duration), rb_obj_freeze(payload) );
+}
+
+
+/*
+ * Return a struct of the size of the given +pool+, re-using one that was freed
+ * if there is one.
+ */
+void *
+rlink_pool_alloc( struct rlink_pool *pool )
+{
+	void *ptr = pool->free;
+
+	if ( !ptr ) return xmalloc( pool->size );
+
+	pool->free = *(void **)ptr;
+	pool->count--;
+
+	return ptr;
+}
+
+
+/*
+ * Return the struct at +ptr+ to the given +pool+, or free it if the pool is full.
+ */
+void
+rlink_pool_free( struct rlink_pool *pool, void *ptr )
+{
+	if ( pool->count >= pool->max ) {
+		xfree( ptr );
+		return;
+	}
+
+	*(void **)ptr = pool->free;
+	pool->free = ptr;
+	pool->count++;
+}
+
+
 /*
  * Raise a LinkParser::Error. The link-grammar library no longer supports fetching the actual
  * error message, so this just raises an exception with "Unknown error" now. Hopefully the
@@ -108,6 +238,126 @@ rlink_make_parse_options( VALUE default_options, VALUE options )
 }
 
 
+/*
+ * Call +func+ with +data+ without holding the GVL if the running Ruby supports it,
+ * using +ubf+ (with +data2+) to unblock it if the calling thread is interrupted. The
+ * function must not touch any Ruby objects.
+ */
+void *
+rlink_without_gvl( void *(*func)(void *), void *data, void (*ubf)(void *), void *data2 )
+{
+#ifdef HAVE_RB_THREAD_CALL_WITHOUT_GVL
+	return rb_thread_call_without_gvl( func, data, ubf, data2 );
+#else
+	return func( data );
+#endif
+}
+
+
+/*
+ * Create a new instance of +klass+, passing the given Hash of +kwargs+ to its
+ * constructor as keyword arguments.
+ */
+VALUE
+rlink_new_with_kwargs( VALUE klass, VALUE kwargs )
+{
+#ifdef HAVE_RB_CLASS_NEW_INSTANCE_KW
+	return rb_class_new_instance_kw( 1, &kwargs, klass, RB_PASS_KEYWORDS );
+#else
+	return rb_class_new_instance( 1, &kwargs, klass );
+#endif
+}
+
+
+/* --------------------------------------------------------------
+ * Interned Strings
+ * -------------------------------------------------------------- */
+
+/*
+ * Mark one of the interned strings. Uses rb_gc_mark() so they aren't moved by
+ * GC.compact out from under the table.
+ */
+static int
+rlink_interned_str_mark_i( st_data_t key, st_data_t value, st_data_t arg )
+{
+	rb_gc_mark( (VALUE)value );
+	return ST_CONTINUE;
+}
+
+
+/*
+ * GC Mark function for the interned strings table
+ */
+static void
+rlink_interned_strings_gc_mark( st_table *table )
+{
+	if ( table ) st_foreach( table, rlink_interned_str_mark_i, 0 );
+}
+
+
+/*
+ * Add the size of one of the interned strings' keys to the total at +arg+.
+ */
+static int
+rlink_interned_str_size_i( st_data_t key, st_data_t value, st_data_t arg )
+{
+	*(size_t *)arg += strlen( (const char *)key ) + 1;
+	return ST_CONTINUE;
+}
+
+
+/*
+ * GC Size function for the interned strings table
+ */
+static size_t
+rlink_interned_strings_memsize( const st_table *table )
+{
+	size_t size = 0;
+
+	if ( !table ) return 0;
+
+	st_foreach( (st_table *)table, rlink_interned_str_size_i, (st_data_t)&size );
+	return size + st_memsize( table );
+}
+
+
+static const rb_data_type_t rlink_interned_strings_type = {
+	"LinkParser::InternedStrings",
+	{
+		(RUBY_DATA_FUNC)rlink_interned_strings_gc_mark,
+		0,
+		(size_t (*)(const void *))rlink_interned_strings_memsize,
+	},
+	0,
+	0,
+	RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+
+/*
+ * Return a frozen String with the contents of +str+, or nil if it's NULL. Link
+ * labels and word spellings come from a small vocabulary, so the same String is
+ * returned every time for the same contents instead of allocating a new one.
+ * Doesn't call any Ruby code.
+ */
+VALUE
+rlink_interned_str( const char *str )
+{
+	st_data_t value;
+	VALUE rval;
+
+	if ( !str ) return Qnil;
+	if ( st_lookup(rlink_interned_strings, (st_data_t)str, &value) )
+		return (VALUE)value;
+
+	rval = rb_obj_freeze( rb_str_new2(str) );
+	if ( rlink_interned_strings->num_entries < RLINK_MAX_INTERNED_STRINGS )
+		st_insert( rlink_interned_strings, (st_data_t)ruby_strdup(str), (st_data_t)rval );
+
+	return rval;
+}
+
+
 /*
  *  call-seq:
  *     LinkParser.link_grammar_version   -> string
@@ -163,10 +413,26 @@ Init_linkparser_ext()
 		rlink_link_grammar_version, 0 );
 	rb_define_singleton_method( rlink_mLinkParser, "link_grammar_config",
 		rlink_link_grammar_config, 0 );
+	rb_define_singleton_method( rlink_mLinkParser, "refresh_log_level",
+		rlink_s_refresh_log_level, 0 );
+	rb_define_singleton_method( rlink_mLinkParser, "refresh_subscriptions",
+		rlink_s_refresh_subscriptions, 0 );
+
+	rlink_s_refresh_log_level( rlink_mLinkParser );
+
+	rb_gc_register_address( &rlink_cParseResult );
+	rb_gc_register_address( &rlink_cParseResultLinkage );
+
+	rlink_interned_strings = st_init_strtable();
+	rlink_interned_strings_holder = TypedData_Wrap_Struct( 0, &rlink_interned_strings_type,
+		rlink_interned_strings );
+	rb_gc_register_address( &rlink_interned_strings_holder );
 
 	rlink_init_dict();
 	rlink_init_sentence();
 	rlink_init_linkage();
 	rlink_init_parseoptions();
+	rlink_init_dump();
+	rlink_init_stats();
 }
 
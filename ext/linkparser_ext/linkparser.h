@@ -19,11 +19,22 @@
 #include <assert.h>
 
 #include <ruby.h>
+#include <ruby/util.h>
+#ifdef HAVE_RUBY_THREAD_H
+#include <ruby/thread.h>
+#endif
 
 #include <link-grammar/link-includes.h>
 
 #include "extconf.h"
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
 /* --------------------------------------------------------------
  * Declarations
  * -------------------------------------------------------------- */
@@ -31,17 +42,62 @@
 #ifdef HAVE_STDARG_PROTOTYPES
 #include <stdarg.h>
 #define va_init_list(a,b) va_start(a,b)
-void rlink_log_obj( VALUE, const char *, const char *, ... );
-void rlink_log( const char *, const char *, ... );
+void rlink_log_obj_message( VALUE, const char *, const char *, ... );
+void rlink_log_message( const char *, const char *, ... );
 #else
 #include <varargs.h>
 #define va_init_list(a,b) va_start(a)
-void rlink_log_obj( VALUE, const char *, const char *, va_dcl );
-void rlink_log( const char *, const char *, va_dcl );
+void rlink_log_obj_message( VALUE, const char *, const char *, va_dcl );
+void rlink_log_message( const char *, const char *, va_dcl );
+#endif
+
+/*
+ * Logging. The logger's level is cached in rlink_log_threshold (and kept up to
+ * date by LinkParser.logger), so a message that won't be logged costs one
+ * comparison: its arguments aren't even evaluated. Building with
+ * RLINK_DISABLE_DEBUG_LOGGING (extconf.rb --disable-debug-logging) compiles
+ * debug messages out entirely.
+ */
+#define RLINK_LOG_DEBUG 0
+#define RLINK_LOG_INFO  1
+#define RLINK_LOG_WARN  2
+#define RLINK_LOG_ERROR 3
+#define RLINK_LOG_FATAL 4
+
+extern int rlink_log_threshold;
+
+/* Map a level name to its number; folds to a constant for a string literal */
+#define rlink_log_level( level ) ( \
+	(level)[0] == 'd' ? RLINK_LOG_DEBUG : \
+	(level)[0] == 'i' ? RLINK_LOG_INFO : \
+	(level)[0] == 'w' ? RLINK_LOG_WARN : \
+	(level)[0] == 'e' ? RLINK_LOG_ERROR : RLINK_LOG_FATAL )
+
+#ifdef RLINK_DISABLE_DEBUG_LOGGING
+# define rlink_log_enabled( level ) \
+	( rlink_log_level(level) != RLINK_LOG_DEBUG && rlink_log_level(level) >= rlink_log_threshold )
+#else
+# define rlink_log_enabled( level ) ( rlink_log_level(level) >= rlink_log_threshold )
 #endif
 
+#define rlink_log( level, ... ) do { \
+	if ( rlink_log_enabled(level) ) rlink_log_message( (level), __VA_ARGS__ ); \
+} while (0)
+#define rlink_log_obj( context, level, ... ) do { \
+	if ( rlink_log_enabled(level) ) rlink_log_obj_message( (context), (level), __VA_ARGS__ ); \
+} while (0)
+
 extern void rlink_raise_lp_error _(( void ));
 extern VALUE rlink_make_parse_options _(( VALUE, VALUE ));
+extern VALUE rlink_copy_parse_options _(( VALUE ));
+extern VALUE rlink_dict_parse_options _(( VALUE, VALUE ));
+extern VALUE rlink_sentence_parse_batch _(( VALUE, VALUE, VALUE, int, long ));
+extern void *rlink_without_gvl _(( void *(*)(void *), void *, void (*)(void *), void * ));
+extern VALUE rlink_new_with_kwargs _(( VALUE, VALUE ));
+extern VALUE rlink_linkage_result_attrs _(( Linkage ));
+extern VALUE rlink_interned_str _(( const char * ));
+extern VALUE rlink_linkage_link_desc _(( const char * ));
+extern VALUE rlink_dump_sentence _(( Sentence, Parse_Options, int, VALUE ));
 
 
 /* -------------------------------------------------------
@@ -61,31 +117,154 @@ extern VALUE rlink_cPostProcessor;
 extern VALUE rlink_cConstituentTree;
 
 extern VALUE rlink_sLinkageCTree;
+extern VALUE rlink_sLinkageLink;
+extern VALUE rlink_cParseResult;
+extern VALUE rlink_cParseResultLinkage;
 
 extern VALUE rlink_eLpError;
 
 
 /*
  * Structures
+ *
+ * Thread-safety: link-grammar allows any number of Sentences to be parsed at
+ * the same time against a single Dictionary, so parsing (and sentence
+ * creation) is done without the GVL, and an rlink_dictionary may be shared
+ * freely between Ruby threads. Its fields are only written by
+ * Dictionary#initialize.
+ *
+ * An rlink_sentence, on the other hand, may only be used by one thread at a
+ * time: the +parsing+ flag is set (with the GVL held) for the duration of a
+ * parse, and any other attempt to use the underlying Sentence while it's set
+ * raises a LinkParser::Error instead of racing with the parser.
  */
 struct rlink_dictionary {
 	Dictionary dict;
+	struct rlink_dict_ref *ref;
+
+	/* The Dictionary that owns +dict+ if this one is a copy of it, or nil */
+	VALUE parent;
+
+	/* Compiled ParseOptions keyed by override Hash, and the option Hash they
+	   were built from (see rlink_dict_parse_options()) */
+	VALUE options_cache;
+	VALUE options_snapshot;
+};
+
+/* A link-grammar Dictionary, counting the Dictionary objects and Sentences that
+   use it. Sentences have to be deleted before their Dictionary, so it's only
+   deleted once they're all gone, whatever order the GC frees them in. */
+struct rlink_dict_ref {
+	Dictionary	dict;
+	long		refcount;
+	size_t		native_size;
+};
+
+/* Timings and search statistics of a parse (see stats.c) */
+struct rlink_parse_stats {
+	int			recorded;
+	double		split_time;
+	double		split_cpu_time;
+	double		parse_time;
+	double		parse_cpu_time;
+	int			timer_expired;
+	int			memory_exhausted;
+	int			null_count;
+	int			max_null_count;
+	int			linkages_found;
+	int			linkages_post_processed;
+	int			valid_linkages;
+	int			stage;
+};
+
+/* The wall-clock and CPU time a timer was started at (see rlink_timer_start()) */
+struct rlink_timer {
+	double		wall;
+	double		cpu;
 };
 
 struct rlink_sentence {
 	Sentence	sentence;
+	struct rlink_dict_ref *dictref;
+
+	/* The estimated size of the link-grammar sentence, as reported to the GC */
+	size_t		native_size;
+
 	VALUE		dictionary;
 	VALUE		parsed_p;
+	VALUE		aborted_p;
 	VALUE		options;
+	VALUE		linkages;
+	int			parsing;
+
+	/* How many of the linkages to keep (the :top_k option), or 0 for all of them */
+	int			top_k;
+
+	/* Incremented each time the sentence is parsed, which frees its old linkages */
+	unsigned long generation;
+
+	/* The stats of the last successful parse */
+	struct rlink_parse_stats stats;
 };
 
 struct rlink_linkage {
 	Linkage		linkage;
 	VALUE		sentence;
+	unsigned long generation;
+
+	/* Frozen data extracted from the linkage the first time it's asked for */
+	VALUE		words;
+	VALUE		links;
+	VALUE		disjunct_strings;
 };
 
 
 
+/* Tell the GC about memory allocated (or freed, if negative) by link-grammar, so
+   it runs as often as the process's real memory use calls for */
+#ifdef HAVE_RB_GC_ADJUST_MEMORY_USAGE
+# define rlink_adjust_memory_usage( diff ) rb_gc_adjust_memory_usage( diff )
+#else
+# define rlink_adjust_memory_usage( diff ) ( (void)(diff) )
+#endif
+
+/* link-grammar doesn't say how much memory its dictionaries and sentences use,
+   so it's estimated with these figures. They're orders of magnitude for
+   link-grammar 5.x with its English dictionary rather than exact sizes, and can
+   be off by a factor of a few either way for other versions, languages, and
+   texts. experiments/memory_bench.rb (`rake bench:memory`) compares them with
+   how much the process's RSS grows for a corpus, and records the link-grammar
+   version and corpus it was run with; re-run it with --check to see if they
+   need adjusting after upgrading link-grammar.
+
+   The linkages belong to the sentence, so they're only counted there. */
+
+/* A loaded dictionary: the English one's word lists, expressions, and
+   post-processing rules. Smaller dictionaries are over-counted. */
+#define RLINK_DICTIONARY_BYTES				( 32 * 1024 * 1024 )
+
+/* Each word of a tokenized sentence: its alternatives and their disjuncts */
+#define RLINK_SENTENCE_BYTES_PER_WORD		2048
+
+/* A parse's count table and parse set, which grow with the square of the length */
+#define RLINK_PARSE_BYTES_PER_WORD_PAIR		128
+
+/* Each word of a post-processed linkage: its links, words, and disjunct strings */
+#define RLINK_LINKAGE_BYTES_PER_WORD		256
+
+/* A free list of structs of the same size, which saves a malloc() and free() for
+   each wrapper object when they're created at a high rate. Only used with the GVL
+   held (including from free functions). */
+struct rlink_pool {
+	size_t	size;
+	long	count;
+	long	max;
+	void	*free;
+};
+
+#define RLINK_POOL_INIT( type, max ) { sizeof(type), 0, (max), NULL }
+
+
 /*
  * Macros
  */
@@ -103,11 +282,39 @@ extern void rlink_init_dict							_(( void ));
 extern void rlink_init_sentence						_(( void ));
 extern void rlink_init_linkage						_(( void ));
 extern void rlink_init_parseoptions					_(( void ));
+extern void rlink_init_dump							_(( void ));
+extern void rlink_init_stats						_(( void ));
 
 /* Fetchers */
 extern struct rlink_dictionary * rlink_get_dict		_(( VALUE ));
 extern struct rlink_sentence *rlink_get_sentence	_(( VALUE ));
 extern Parse_Options rlink_get_parseopts			_(( VALUE ));
 
+/* Wrapper struct memory (see linkparser.c and dictionary.c) */
+extern void *rlink_pool_alloc _(( struct rlink_pool * ));
+extern void rlink_pool_free _(( struct rlink_pool *, void * ));
+extern struct rlink_dict_ref *rlink_dict_ref_retain _(( struct rlink_dict_ref * ));
+extern void rlink_dict_ref_release _(( struct rlink_dict_ref * ));
+extern void rlink_linkage_detach _(( VALUE ));
+extern int rlink_sentence_linkage_count _(( struct rlink_sentence * ));
+extern int rlink_dict_top_k _(( VALUE ));
+
+/* Instrumentation events (see LinkParser.subscribe) */
+#define RLINK_EVENT_DICTIONARY_LOAD		( 1 << 0 )
+#define RLINK_EVENT_PARSE				( 1 << 1 )
+#define RLINK_EVENT_LINKAGE				( 1 << 2 )
+
+/* The events that have subscribers, so publishing can be skipped if there aren't any */
+extern int rlink_event_mask;
+#define rlink_subscribed( event ) ( rlink_event_mask & (event) )
+
+extern void rlink_publish_event _(( const char *, double, VALUE ));
+
+/* Parse stats (see stats.c) */
+extern void rlink_timer_start _(( struct rlink_timer * ));
+extern void rlink_timer_stop _(( struct rlink_timer *, double *, double * ));
+extern void rlink_parse_stats_finish _(( struct rlink_parse_stats *, Sentence, Parse_Options ));
+extern VALUE rlink_parse_stats_hash _(( struct rlink_parse_stats * ));
+
 #endif /* _R_LINKPARSER_H */
 
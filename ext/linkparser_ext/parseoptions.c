@@ -40,20 +40,42 @@ rlink_parseopts_gc_free( Parse_Options parseopts )
 }
 
 
+/*
+ * GC Size function. link-grammar doesn't say how big its Parse_Options are, so
+ * this is just the size of a pointer to one.
+ */
+static size_t
+rlink_parseopts_memsize( const void *parseopts )
+{
+	return parseopts ? sizeof( Parse_Options ) : 0;
+}
+
+
+static const rb_data_type_t rlink_parseopts_type = {
+	"LinkParser::ParseOptions",
+	{
+		0,
+		(RUBY_DATA_FUNC)rlink_parseopts_gc_free,
+		rlink_parseopts_memsize,
+	},
+	0,
+	0,
+	RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+
 /*
  * Object validity checker. Returns the data pointer.
  */
 static Parse_Options
 check_parseopts( VALUE self )
 {
-	Check_Type( self, T_DATA );
-
-    if ( !IsParseOptions(self) ) {
+    if ( !rb_typeddata_is_kind_of(self, &rlink_parseopts_type) ) {
 		rb_raise( rb_eTypeError, "wrong argument type %s (expected LinkParser::ParseOptions)",
 				  rb_class2name(CLASS_OF( self )) );
     }
 
-	return DATA_PTR( self );
+	return RTYPEDDATA_DATA( self );
 }
 
 
@@ -83,6 +105,48 @@ rlink_get_parseopts( VALUE obj )
 }
 
 
+/*
+ * Copy the settings from the +src+ Parse_Options to +dst+.
+ */
+static void
+rlink_parseopts_copy_settings( Parse_Options dst, Parse_Options src )
+{
+	parse_options_set_verbosity( dst, parse_options_get_verbosity(src) );
+	parse_options_set_linkage_limit( dst, parse_options_get_linkage_limit(src) );
+	parse_options_set_disjunct_cost( dst, parse_options_get_disjunct_cost(src) );
+	parse_options_set_min_null_count( dst, parse_options_get_min_null_count(src) );
+	parse_options_set_max_null_count( dst, parse_options_get_max_null_count(src) );
+	parse_options_set_islands_ok( dst, parse_options_get_islands_ok(src) );
+	parse_options_set_short_length( dst, parse_options_get_short_length(src) );
+	parse_options_set_max_memory( dst, parse_options_get_max_memory(src) );
+	parse_options_set_max_parse_time( dst, parse_options_get_max_parse_time(src) );
+	parse_options_set_all_short_connectors( dst, parse_options_get_all_short_connectors(src) );
+	parse_options_set_cost_model_type( dst, parse_options_get_cost_model_type(src) );
+#ifdef HAVE_PARSE_OPTIONS_GET_SPELL_GUESS
+	parse_options_set_spell_guess( dst, parse_options_get_spell_guess(src) );
+#endif /* HAVE_PARSE_OPTIONS_GET_SPELL_GUESS */
+}
+
+
+/*
+ * Return a new LinkParser::ParseOptions with the same settings as +options+. This
+ * is the same as +options.dup+, but is done entirely in C, so it's cheap enough
+ * to do for every sentence.
+ */
+VALUE
+rlink_copy_parse_options( VALUE options )
+{
+	Parse_Options src = get_parseopts( options ),
+	              dst = parse_options_create();
+	VALUE copy = TypedData_Wrap_Struct( rlink_cParseOptions, &rlink_parseopts_type, dst );
+
+	rlink_parseopts_copy_settings( dst, src );
+
+	return copy;
+}
+
+
+
 /* --------------------------------------------------
  * Class Methods
  * -------------------------------------------------- */
@@ -97,7 +161,7 @@ static VALUE
 rlink_parseopts_s_alloc( VALUE klass )
 {
 	rlink_log( "debug", "Wrapping an uninitialized ParseOptions pointer."  );
-	return Data_Wrap_Struct( klass, 0, rlink_parseopts_gc_free, 0 );
+	return TypedData_Wrap_Struct( klass, &rlink_parseopts_type, 0 );
 }
 
 
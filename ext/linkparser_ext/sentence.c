@@ -21,6 +21,74 @@
  * Macros and constants
  * -------------------------------------------------- */
 
+static VALUE text_sym;
+static VALUE null_count_sym;
+static VALUE num_linkages_found_sym;
+static VALUE linkages_sym;
+static VALUE strategy_sym;
+static VALUE ladder_sym;
+static VALUE single_sym;
+static VALUE adaptive_sym;
+
+/* Freed rlink_sentence structs kept for re-use */
+static struct rlink_pool rlink_sentence_pool = RLINK_POOL_INIT( struct rlink_sentence, 256 );
+
+/* Arguments to and results of a sentence_create() call made without the GVL */
+struct rlink_create_call {
+	const char	*input;
+	Dictionary	dict;
+	Sentence	sentence;
+};
+
+/* Arguments to and results of a sentence_split() call made without the GVL */
+struct rlink_split_call {
+	struct rlink_sentence	*ptr;
+	Parse_Options			opts;
+	int						result;
+};
+
+/* Arguments to and results of a sentence_parse() call made without the GVL. An
+   adaptive parse tries each of several stages' options in turn. */
+struct rlink_parse_call {
+	struct rlink_sentence	*ptr;
+	Parse_Options			*stages;
+	int						*max_parse_times;
+	int						nstages;
+	int						stage;
+	int						link_count;
+	int						finished;
+	volatile int			interrupted;
+	struct rlink_parse_stats stats;
+};
+
+/* One sentence of a batch parse */
+struct rlink_batch_job {
+	const char		*input;
+	Sentence		sentence;
+	Parse_Options	opts;
+	int				max_parse_time;
+	int				link_count;
+	int				done;
+	struct rlink_parse_stats stats;
+};
+
+/* The state shared by the workers of a batch parse */
+struct rlink_batch_call {
+	Dictionary				dict;
+	struct rlink_batch_job	*jobs;
+	long					count;
+	long					next;
+	long					nthreads;
+	long					failed;
+	int						finished;
+	volatile int			interrupted;
+	VALUE					sentences;
+	VALUE					options;
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_t			lock;
+#endif
+};
+
 
 /* --------------------------------------------------
  *	Memory-management functions
@@ -32,12 +100,20 @@
 static struct rlink_sentence *
 rlink_sentence_alloc()
 {
-	struct rlink_sentence *ptr = ALLOC( struct rlink_sentence );
+	struct rlink_sentence *ptr = rlink_pool_alloc( &rlink_sentence_pool );
 
 	ptr->sentence	= NULL;
+	ptr->dictref	= NULL;
+	ptr->native_size = 0;
 	ptr->dictionary	= Qnil;
 	ptr->parsed_p	= Qfalse;
+	ptr->aborted_p	= Qfalse;
 	ptr->options	= Qnil;
+	ptr->linkages	= Qnil;
+	ptr->parsing	= 0;
+	ptr->top_k		= 0;
+	ptr->generation	= 0;
+	MEMZERO( &ptr->stats, struct rlink_parse_stats, 1 );
 
 	rlink_log( "debug", "Initialized an rlink_sentence <%p>", ptr  );
 	return ptr;
@@ -53,6 +129,7 @@ rlink_sentence_gc_mark( struct rlink_sentence *ptr )
 	if ( ptr ) {
 		rb_gc_mark( ptr->dictionary );
 		rb_gc_mark( ptr->options );
+		rb_gc_mark( ptr->linkages );
 	}
 }
 
@@ -64,41 +141,128 @@ static void
 rlink_sentence_gc_free( struct rlink_sentence *ptr )
 {
 	if ( ptr ) {
-		if ( ptr->dictionary && TYPE(ptr->dictionary) == T_DATA ) {
-			struct rlink_dictionary *dictionary = rlink_get_dict( ptr->dictionary );
-
-			/* Freeing the dictionary automatically frees the sentences it belongs to, so
-			   don't double-free if the dictionary struct or its pointer is done. */
-			if ( dictionary->dict && ptr->sentence ) {
-				rlink_log( "Deleting sentence %p", "debug", ptr->sentence );
-				sentence_delete( (Sentence)ptr->sentence );
-			}
-		}
+		/* The Dictionary object might already have been freed, but the link-grammar
+		   dictionary is kept until its last sentence is deleted. */
+		if ( ptr->sentence )
+			sentence_delete( (Sentence)ptr->sentence );
+		rlink_adjust_memory_usage( -(ssize_t)ptr->native_size );
+		rlink_dict_ref_release( ptr->dictref );
 
 		ptr->sentence = NULL;
+		ptr->dictref = NULL;
 		ptr->options = Qnil;
 		ptr->dictionary = Qnil;
 
-		xfree( ptr );
+		rlink_pool_free( &rlink_sentence_pool, ptr );
 		ptr = NULL;
 	}
 }
 
 
+/*
+ * GC Size function
+ */
+static size_t
+rlink_sentence_memsize( const struct rlink_sentence *ptr )
+{
+	return ptr ? sizeof( struct rlink_sentence ) + ptr->native_size : 0;
+}
+
+
+/*
+ * Estimate how much memory link-grammar is using for the sentence pointed to by
+ * +ptr+, and tell the GC how much that's changed since the last estimate. Must be
+ * called with the GVL held while no other thread is using the sentence.
+ */
+static void
+rlink_sentence_update_native_size( struct rlink_sentence *ptr )
+{
+	size_t size = 0, length;
+	int linkages;
+
+	if ( ptr->sentence ) {
+		length = sentence_length( (Sentence)ptr->sentence );
+		size = length * RLINK_SENTENCE_BYTES_PER_WORD;
+
+		if ( RTEST(ptr->parsed_p) ) {
+			linkages = sentence_num_linkages_post_processed( (Sentence)ptr->sentence );
+			size += length * length * RLINK_PARSE_BYTES_PER_WORD_PAIR;
+			if ( linkages > 0 )
+				size += linkages * length * RLINK_LINKAGE_BYTES_PER_WORD;
+		}
+	}
+
+	rlink_adjust_memory_usage( (ssize_t)size - (ssize_t)ptr->native_size );
+	ptr->native_size = size;
+}
+
+
+/*
+ * Return the number of linkages of the parsed sentence pointed to by +ptr+ that are
+ * visible from Ruby: the valid ones, or only the first +top_k+ of them if that
+ * option was given to the parse.
+ */
+int
+rlink_sentence_linkage_count( struct rlink_sentence *ptr )
+{
+	int count = sentence_num_valid_linkages( (Sentence)ptr->sentence );
+
+	if ( ptr->top_k > 0 && count > ptr->top_k )
+		count = ptr->top_k;
+
+	return count;
+}
+
+
+/*
+ * Detach the Linkages made from the current parse of the sentence pointed to by
+ * +ptr+ before link-grammar frees them, which it does when the sentence is parsed
+ * again or deleted. Ones that were handed out can still return whatever was
+ * already extracted from them, and any others (e.g., from Linkage.new) are
+ * caught by the generation check in get_linkage(). Doesn't call into Ruby.
+ */
+static void
+rlink_sentence_detach_linkages( struct rlink_sentence *ptr )
+{
+	long i;
+
+	if ( RB_TYPE_P(ptr->linkages, T_ARRAY) ) {
+		for ( i = 0; i < RARRAY_LEN(ptr->linkages); i++ ) {
+			VALUE linkage = RARRAY_AREF( ptr->linkages, i );
+			if ( !NIL_P(linkage) ) rlink_linkage_detach( linkage );
+		}
+	}
+
+	ptr->linkages = Qnil;
+	ptr->generation++;
+}
+
+
+static const rb_data_type_t rlink_sentence_type = {
+	"LinkParser::Sentence",
+	{
+		(RUBY_DATA_FUNC)rlink_sentence_gc_mark,
+		(RUBY_DATA_FUNC)rlink_sentence_gc_free,
+		(size_t (*)(const void *))rlink_sentence_memsize,
+	},
+	0,
+	0,
+	RUBY_TYPED_FREE_IMMEDIATELY,
+};
+
+
 /*
  * Object validity checker. Returns the data pointer.
  */
 static struct rlink_sentence *
 check_sentence(  VALUE	self )
 {
-	Check_Type( self, T_DATA );
-
-    if ( !IsSentence(self) ) {
+    if ( !rb_typeddata_is_kind_of(self, &rlink_sentence_type) ) {
 		rb_raise( rb_eTypeError, "wrong argument type %s (expected LinkParser::Sentence)",
 				  rb_class2name(CLASS_OF( self )) );
     }
 
-	return DATA_PTR( self );
+	return RTYPEDDATA_DATA( self );
 }
 
 
@@ -117,6 +281,24 @@ get_sentence(  VALUE self )
 }
 
 
+/*
+ * Fetch the data pointer, check it for sanity, and make sure it isn't being
+ * parsed by another thread.
+ */
+static struct rlink_sentence *
+get_idle_sentence( VALUE self )
+{
+	struct rlink_sentence *ptr = get_sentence( self );
+
+	if ( ptr->parsing )
+		rb_raise( rlink_eLpError, "Sentence is being parsed by another thread" );
+	if ( !ptr->sentence )
+		rb_raise( rlink_eLpError, "Sentence has been released" );
+
+	return ptr;
+}
+
+
 /*
  * Publicly-usable sentence-fetcher
  */
@@ -128,6 +310,357 @@ rlink_get_sentence( VALUE self )
 
 
 
+/* --------------------------------------------------
+ * GVL-free functions
+ * -------------------------------------------------- */
+
+/*
+ * Create the link-grammar Sentence for a rlink_create_call.
+ */
+static void *
+rlink_sentence_create_nogvl( void *data )
+{
+	struct rlink_create_call *call = (struct rlink_create_call *)data;
+
+	call->sentence = sentence_create( call->input, call->dict );
+
+	return NULL;
+}
+
+
+#ifdef HAVE_SENTENCE_SPLIT
+/*
+ * Split the link-grammar Sentence for a rlink_split_call into words.
+ */
+static void *
+rlink_sentence_split_nogvl( void *data )
+{
+	struct rlink_split_call *call = (struct rlink_split_call *)data;
+
+	call->result = sentence_split( (Sentence)call->ptr->sentence, call->opts );
+
+	return NULL;
+}
+
+
+/*
+ * Split the sentence of the given rlink_split_call without the GVL (rb_ensure body).
+ * Splitting can't be cancelled, so there's no unblocking function.
+ */
+static VALUE
+rlink_sentence_do_split( VALUE data )
+{
+	rlink_without_gvl( rlink_sentence_split_nogvl, (void *)data, NULL, NULL );
+	return Qnil;
+}
+
+
+/*
+ * Mark the sentence of the given rlink_split_call as no longer busy (rb_ensure
+ * ensure).
+ */
+static VALUE
+rlink_sentence_finish_split( VALUE data )
+{
+	struct rlink_split_call *call = (struct rlink_split_call *)data;
+
+	call->ptr->parsing = 0;
+	return Qnil;
+}
+#endif /* HAVE_SENTENCE_SPLIT */
+
+
+/*
+ * Split the given +sentence+ into words if it hasn't been already, then parse it
+ * with +opts+, recording how long each step took in +stats+. Doesn't need the
+ * GVL. Returns the number of linkages found, or -1 if there was an error.
+ * Post-processing is part of link-grammar's parse, so it's included in the
+ * parse time.
+ */
+static int
+rlink_sentence_timed_parse( Sentence sentence, Parse_Options opts, struct rlink_parse_stats *stats )
+{
+	struct rlink_timer timer;
+	double wall, cpu;
+	int link_count;
+
+#ifdef HAVE_SENTENCE_SPLIT
+	if ( sentence_length(sentence) == 0 ) {
+		rlink_timer_start( &timer );
+		if ( sentence_split(sentence, opts) != 0 ) return -1;
+		rlink_timer_stop( &timer, &stats->split_time, &stats->split_cpu_time );
+	}
+#endif
+
+	/* Adaptive parses add up the time of each stage */
+	rlink_timer_start( &timer );
+	link_count = sentence_parse( sentence, opts );
+	rlink_timer_stop( &timer, &wall, &cpu );
+	stats->parse_time += wall;
+	stats->parse_cpu_time += cpu;
+
+	return link_count;
+}
+
+
+/*
+ * Publish a +parse+ event for a sentence of +length+ words that was parsed with
+ * +options+ (a LinkParser::ParseOptions), with the given +stats+, or that +failed+.
+ * Everything needed from link-grammar has to be extracted before calling this,
+ * since the subscribers can switch threads.
+ */
+static void
+rlink_sentence_publish_parse( const struct rlink_parse_stats *statsptr, int length, int failed,
+	VALUE options )
+{
+	struct rlink_parse_stats stats = *statsptr;
+	VALUE payload = rb_hash_new(), opthash;
+	const char *outcome;
+
+	if ( failed ) outcome = "error";
+	else if ( stats.timer_expired ) outcome = "timeout";
+	else if ( stats.memory_exhausted ) outcome = "memory_exhausted";
+	else if ( stats.valid_linkages == 0 ) outcome = "no_linkages";
+	else outcome = "success";
+
+	rb_hash_aset( payload, ID2SYM(rb_intern("length")), INT2FIX(length) );
+	rb_hash_aset( payload, ID2SYM(rb_intern("outcome")), ID2SYM(rb_intern(outcome)) );
+	rb_hash_aset( payload, ID2SYM(rb_intern("linkages_found")), INT2FIX(stats.linkages_found) );
+	rb_hash_aset( payload, null_count_sym, INT2FIX(stats.null_count) );
+	rb_hash_aset( payload, ID2SYM(rb_intern("stats")), rlink_parse_stats_hash(&stats) );
+	opthash = rb_obj_freeze( rb_funcall(options, rb_intern("to_hash"), 0) );
+	rb_hash_aset( payload, ID2SYM(rb_intern("options")), opthash );
+	rb_hash_aset( payload, ID2SYM(rb_intern("options_fingerprint")),
+		rb_funcall(rlink_mLinkParser, rb_intern("options_fingerprint"), 1, opthash) );
+
+	rlink_publish_event( "parse", stats.split_time + stats.parse_time, payload );
+}
+
+
+/*
+ * Parse the link-grammar Sentence for a rlink_parse_call, starting with its current
+ * stage and moving on to the next until one finds valid linkages or there aren't
+ * any more.
+ */
+static void *
+rlink_sentence_parse_nogvl( void *data )
+{
+	struct rlink_parse_call *call = (struct rlink_parse_call *)data;
+	Sentence sentence = (Sentence)call->ptr->sentence;
+
+	while ( !call->interrupted ) {
+		call->link_count = rlink_sentence_timed_parse( sentence, call->stages[call->stage],
+			&call->stats );
+
+		if ( call->interrupted || call->link_count < 0 ) break;
+		if ( call->stage + 1 >= call->nstages || sentence_num_valid_linkages(sentence) > 0 ) break;
+		call->stage++;
+	}
+
+	return NULL;
+}
+
+
+/*
+ * Reset the time limit of each stage of the given rlink_parse_call to the one it
+ * was set up with.
+ */
+static void
+rlink_sentence_reset_parse_times( struct rlink_parse_call *call )
+{
+	int i;
+
+	for ( i = 0; i < call->nstages; i++ )
+		parse_options_set_max_parse_time( call->stages[i], call->max_parse_times[i] );
+}
+
+
+/*
+ * Unblocking function for a parse: link-grammar doesn't have a way to cancel a
+ * parse, but it does check its timer periodically while it's searching, so
+ * expiring it causes the parse to return as soon as possible.
+ */
+static void
+rlink_sentence_parse_ubf( void *data )
+{
+	struct rlink_parse_call *call = (struct rlink_parse_call *)data;
+	int i;
+
+	call->interrupted = 1;
+	for ( i = 0; i < call->nstages; i++ )
+		parse_options_set_max_parse_time( call->stages[i], 0 );
+}
+
+
+/*
+ * Run the parse for the given rlink_parse_call without the GVL (rb_ensure body).
+ * If the thread is interrupted, the parse is cut short and the interrupt is
+ * delivered when the GVL is re-acquired; if the interrupt turns out not to
+ * raise (e.g., a signal handler that returns normally), the parse is
+ * restarted with the original time limit.
+ */
+static VALUE
+rlink_sentence_do_parse( VALUE data )
+{
+	struct rlink_parse_call *call = (struct rlink_parse_call *)data;
+
+	do {
+		call->interrupted = 0;
+		rlink_sentence_reset_parse_times( call );
+		rlink_without_gvl( rlink_sentence_parse_nogvl, call, rlink_sentence_parse_ubf, call );
+	} while ( call->interrupted );
+
+	call->finished = 1;
+	return Qnil;
+}
+
+
+/*
+ * Mark the sentence of the given rlink_parse_call as no longer being parsed,
+ * and as aborted if the parse didn't finish (rb_ensure ensure).
+ */
+static VALUE
+rlink_sentence_finish_parse( VALUE data )
+{
+	struct rlink_parse_call *call = (struct rlink_parse_call *)data;
+
+	if ( !call->finished ) {
+		rlink_sentence_reset_parse_times( call );
+		call->ptr->parsed_p = Qfalse;
+		call->ptr->aborted_p = Qtrue;
+	}
+
+	call->ptr->parsing = 0;
+
+	return Qnil;
+}
+
+
+/*
+ * Fetch the index of the next job from the given rlink_batch_call that still
+ * needs parsing, or -1 if there aren't any more.
+ */
+static long
+rlink_batch_next_job( struct rlink_batch_call *call )
+{
+	long i;
+
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_lock( &call->lock );
+#endif
+	do {
+		i = call->next++;
+	} while ( i < call->count && call->jobs[i].done );
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_unlock( &call->lock );
+#endif
+
+	if ( i >= call->count || call->interrupted ) return -1;
+	return i;
+}
+
+
+/*
+ * Batch worker: create and parse sentences from the given rlink_batch_call until
+ * there aren't any left, or the batch is interrupted.
+ */
+static void *
+rlink_batch_worker( void *data )
+{
+	struct rlink_batch_call *call = (struct rlink_batch_call *)data;
+	struct rlink_batch_job *job;
+	long i;
+
+	while ( (i = rlink_batch_next_job(call)) >= 0 ) {
+		job = &call->jobs[ i ];
+
+		if ( !job->sentence )
+			job->sentence = sentence_create( job->input, call->dict );
+		if ( job->sentence )
+			job->link_count = rlink_sentence_timed_parse( job->sentence, job->opts, &job->stats );
+
+		/* A parse that was cut short by an interrupt has to be redone */
+		if ( !call->interrupted ) job->done = 1;
+	}
+
+	return NULL;
+}
+
+
+/*
+ * Parse all the jobs of the given rlink_batch_call, spreading them across
+ * +nthreads+ native threads (including the calling one).
+ */
+static void *
+rlink_batch_parse_nogvl( void *data )
+{
+	struct rlink_batch_call *call = (struct rlink_batch_call *)data;
+#ifdef HAVE_PTHREAD_H
+	pthread_t *threads = NULL;
+	long i, started = 0;
+
+	if ( call->nthreads > 1 ) {
+		threads = malloc( sizeof(pthread_t) * (call->nthreads - 1) );
+		for ( i = 0; threads && i < call->nthreads - 1; i++ ) {
+			if ( pthread_create(&threads[i], NULL, rlink_batch_worker, call) != 0 ) break;
+			started++;
+		}
+	}
+
+	rlink_batch_worker( call );
+
+	for ( i = 0; i < started; i++ )
+		pthread_join( threads[i], NULL );
+	free( threads );
+#else
+	rlink_batch_worker( call );
+#endif /* HAVE_PTHREAD_H */
+
+	return NULL;
+}
+
+
+/*
+ * Unblocking function for a batch parse: stop handing out jobs, and expire the
+ * timers of the ones that are in progress.
+ */
+static void
+rlink_batch_parse_ubf( void *data )
+{
+	struct rlink_batch_call *call = (struct rlink_batch_call *)data;
+	long i;
+
+	call->interrupted = 1;
+	for ( i = 0; i < call->count; i++ )
+		parse_options_set_max_parse_time( call->jobs[i].opts, 0 );
+}
+
+
+/*
+ * Run the given rlink_batch_call without the GVL (rb_ensure body), restarting
+ * any unfinished jobs if it's interrupted without raising.
+ */
+static VALUE
+rlink_batch_do_parse( VALUE data )
+{
+	struct rlink_batch_call *call = (struct rlink_batch_call *)data;
+	long i;
+
+	do {
+		call->interrupted = 0;
+		call->next = 0;
+		for ( i = 0; i < call->count; i++ )
+			parse_options_set_max_parse_time( call->jobs[i].opts, call->jobs[i].max_parse_time );
+
+		rlink_without_gvl( rlink_batch_parse_nogvl, call, rlink_batch_parse_ubf, call );
+	} while ( call->interrupted );
+
+	call->finished = 1;
+	return Qnil;
+}
+
+
+
 /* --------------------------------------------------
  * Class Methods
  * -------------------------------------------------- */
@@ -143,7 +676,7 @@ static VALUE
 rlink_sentence_s_alloc(  VALUE klass )
 {
 	rlink_log( "debug", "Wrapping an uninitialized Sentence pointer." );
-	return Data_Wrap_Struct( klass, rlink_sentence_gc_mark, rlink_sentence_gc_free, 0 );
+	return TypedData_Wrap_Struct( klass, &rlink_sentence_type, 0 );
 }
 
 
@@ -166,15 +699,31 @@ rlink_sentence_init( VALUE self, VALUE input_string, VALUE dictionary )
 {
 	if ( !check_sentence(self) ) {
 		struct rlink_sentence *ptr;
-		Sentence sent;
+		struct rlink_create_call call;
 		struct rlink_dictionary *dictptr = rlink_get_dict( dictionary );
 
-		if ( !(sent = sentence_create( StringValueCStr(input_string), dictptr->dict )) )
+		/* Use a frozen copy of the input so it can't change out from under the
+		   tokenizer while the GVL is released. */
+		StringValueCStr( input_string );
+		input_string = rb_str_new_frozen( input_string );
+
+		call.input = RSTRING_PTR( input_string );
+		call.dict = dictptr->dict;
+		call.sentence = NULL;
+
+		/* Creating a sentence is quick and can't be cancelled, so there's no
+		   unblocking function. */
+		rlink_without_gvl( rlink_sentence_create_nogvl, &call, NULL, NULL );
+		RB_GC_GUARD( input_string );
+		RB_GC_GUARD( dictionary );
+
+		if ( !call.sentence )
 			rlink_raise_lp_error();
 
 		DATA_PTR( self ) = ptr = rlink_sentence_alloc();
 
-		ptr->sentence = sent;
+		ptr->sentence = call.sentence;
+		ptr->dictref = rlink_dict_ref_retain( dictptr->ref );
 		ptr->dictionary = dictionary;
 		ptr->options = Qnil;
 
@@ -187,23 +736,91 @@ rlink_sentence_init( VALUE self, VALUE input_string, VALUE dictionary )
 }
 
 
+/*
+ * Take the +:strategy+ and +:ladder+ arguments out of the parse +options+ (replacing
+ * the Hash with a copy, so the caller's isn't changed), and return the Array of
+ * option Hashes for each stage of an +:adaptive+ parse, or nil for a +:single+ one.
+ */
+static VALUE
+rlink_sentence_parse_ladder( VALUE *options )
+{
+	VALUE strategy, ladder;
+
+	if ( TYPE(*options) != T_HASH ) return Qnil;
+
+	strategy = rb_hash_lookup( *options, strategy_sym );
+	ladder = rb_hash_lookup( *options, ladder_sym );
+	if ( NIL_P(strategy) && NIL_P(ladder) ) return Qnil;
+
+	*options = rb_hash_dup( *options );
+	rb_hash_delete( *options, strategy_sym );
+	rb_hash_delete( *options, ladder_sym );
+
+	/* A ladder without a strategy means an adaptive parse */
+	if ( NIL_P(strategy) ) strategy = adaptive_sym;
+	if ( strategy == single_sym ) return Qnil;
+	if ( strategy != adaptive_sym )
+		rb_raise( rb_eArgError, "unknown parse strategy %s",
+			RSTRING_PTR(rb_inspect(strategy)) );
+
+	if ( NIL_P(ladder) )
+		ladder = rb_const_get( rlink_cSentence, rb_intern("ADAPTIVE_LADDER") );
+	ladder = rb_convert_type( ladder, T_ARRAY, "Array", "to_ary" );
+	if ( RARRAY_LEN(ladder) == 0 )
+		rb_raise( rb_eArgError, "an adaptive parse needs at least one stage" );
+
+	return ladder;
+}
+
+
 /*
  *  call-seq:
  *     sentence.parse( options={} )   -> fixnum
+ *     sentence.parse( strategy: :adaptive, ladder: stages, **options )   -> fixnum
  *
  *  Attach a parse set to this sentence and return the number of linkages
  *  found. If any +options+ are specified, they override those set in the
  *  sentence's dictionary.
  *
+ *  A +:top_k+ option keeps only the first that many of the valid linkages, which
+ *  link-grammar sorts by cost, so the rest are never extracted from it. The parse
+ *  itself is the same as without it, so #num_linkages_found still counts all of the
+ *  linkages that were found, but #num_valid_linkages, #linkage, and the results of
+ *  #freeze_result and #dump only see the ones that were kept. If more than
+ *  +:linkage_limit+ linkages are found, link-grammar only extracts a random sample
+ *  of them as usual, so raise that too if the kept ones need to be the best of all of
+ *  them.
+ *
+ *     sentence.parse( top_k: 1 )   #-> 12
+ *     sentence.num_valid_linkages  #-> 1
+ *
+ *  With the +:adaptive+ +strategy+, the sentence is parsed with each stage of the
+ *  +ladder+ (an Array of option Hashes, each applied on top of the +options+) in
+ *  turn until one finds valid linkages, re-using the same tokenized sentence. The
+ *  default ladder is ADAPTIVE_LADDER, which starts with a cheap parse without
+ *  null links and only goes on to more expensive ones if that fails. The stage
+ *  that was used is the <tt>:stage</tt> of the #parse_stats, and the #options
+ *  are that stage's.
+ *
+ *     sentence.parse( strategy: :adaptive )   #-> 2
+ *     sentence.parse_stats[:stage]            #-> 0
+ *
+ *  The parse itself is done without holding the GVL, so other threads (including
+ *  ones parsing other sentences from the same Dictionary) can run while it's
+ *  in progress. It can also be interrupted (e.g., by Thread#raise, Timeout, or
+ *  Ctrl-C), in which case the sentence is left unparsed and #aborted? will
+ *  return +true+ until it's successfully parsed again.
+ *
  */
 static VALUE
 rlink_sentence_parse( int argc, VALUE *argv, VALUE self )
 {
 	struct rlink_sentence *ptr = get_sentence( self );
-	Parse_Options opts;
-	VALUE defopts = Qnil;
-	VALUE options = Qnil;
-	int link_count = 0;
+	struct rlink_parse_call call;
+	Parse_Options *stages;
+	int *max_parse_times, top_k;
+	VALUE options = Qnil, ladder, stageopts, stage, stages_buf = 0, times_buf = 0;
+	long i;
 
 	/*
 	if ( RTEST(ptr->parsed_p) )
@@ -211,24 +828,149 @@ rlink_sentence_parse( int argc, VALUE *argv, VALUE self )
 	*/
 	rlink_log_obj( self, "debug", "Parsing sentence <%p>", ptr  );
 
-	/* Merge the hash from this call with the one from the dict and build
-	   Parse_Options from it. */
+	/* Get ParseOptions for the dict's options merged with the ones from this call
+	   (and those of each stage, for an adaptive parse) */
 	rb_scan_args( argc, argv, "01", &options );
-	defopts = rb_funcall( ptr->dictionary, rb_intern("options"), 0 );
+	top_k = rlink_dict_top_k( options );
+	ladder = rlink_sentence_parse_ladder( &options );
+	if ( NIL_P(ladder) ) {
+		stageopts = rb_ary_new_from_args( 1, rlink_dict_parse_options(ptr->dictionary, options) );
+	} else {
+		stageopts = rb_ary_new2( RARRAY_LEN(ladder) );
+		for ( i = 0; i < RARRAY_LEN(ladder); i++ ) {
+			stage = rb_convert_type( RARRAY_AREF(ladder, i), T_HASH, "Hash", "to_hash" );
+			if ( !NIL_P(options) )
+				stage = rb_funcall( options, rb_intern("merge"), 1, stage );
+			rb_ary_push( stageopts, rlink_dict_parse_options(ptr->dictionary, stage) );
+		}
+	}
 
-	/* Turn the option hash into a ParseOptions object, then extract the
-	   Parse_Options struct from that  */
-	options = rlink_make_parse_options( defopts, options );
-	opts = rlink_get_parseopts( options );
+	/* Then extract the Parse_Options structs from them */
+	call.nstages = (int)RARRAY_LEN( stageopts );
+	call.stages = stages = ALLOCV_N( Parse_Options, stages_buf, call.nstages );
+	call.max_parse_times = max_parse_times = ALLOCV_N( int, times_buf, call.nstages );
+	for ( i = 0; i < call.nstages; i++ ) {
+		stages[i] = rlink_get_parseopts( RARRAY_AREF(stageopts, i) );
+		max_parse_times[i] = parse_options_get_max_parse_time( stages[i] );
+	}
 
-	/* Parse the sentence */
-	if ( (link_count = sentence_parse( ptr->sentence, opts )) < 0 )
+	/* Parse the sentence. Building the options can switch threads, so the check
+	   for a parse that's already in progress has to happen after that. */
+	call.ptr = ptr;
+	call.stage = 0;
+	call.link_count = -1;
+	call.finished = 0;
+	call.interrupted = 0;
+	MEMZERO( &call.stats, struct rlink_parse_stats, 1 );
+
+	if ( ptr->parsing )
+		rb_raise( rlink_eLpError, "Sentence is being parsed by another thread" );
+	if ( !ptr->sentence )
+		rb_raise( rlink_eLpError, "Sentence has been released" );
+	ptr->parsing = 1;
+	ptr->top_k = top_k;
+	rlink_sentence_detach_linkages( ptr );
+	rb_ensure( rlink_sentence_do_parse, (VALUE)&call, rlink_sentence_finish_parse, (VALUE)&call );
+	options = RARRAY_AREF( stageopts, call.stage );
+	RB_GC_GUARD( stageopts );
+
+	if ( call.link_count < 0 ) {
+		ALLOCV_END( stages_buf );
+		ALLOCV_END( times_buf );
+		if ( rlink_subscribed(RLINK_EVENT_PARSE) )
+			rlink_sentence_publish_parse( &call.stats, 0, 1, options );
 		rlink_raise_lp_error();
+	}
+
+	call.stats.stage = call.stage;
+	rlink_parse_stats_finish( &call.stats, (Sentence)ptr->sentence, stages[call.stage] );
+	ALLOCV_END( stages_buf );
+	ALLOCV_END( times_buf );
 
+	ptr->stats = call.stats;
 	ptr->options = options;
 	ptr->parsed_p = Qtrue;
+	ptr->aborted_p = Qfalse;
+	rlink_sentence_update_native_size( ptr );
+
+	if ( rlink_subscribed(RLINK_EVENT_PARSE) )
+		rlink_sentence_publish_parse( &call.stats, sentence_length((Sentence)ptr->sentence), 0,
+			options );
+
+	return INT2FIX( call.link_count );
+}
+
+
+/*
+ *  call-seq:
+ *     sentence.tokenize( options={} )   -> sentence
+ *
+ *  Split the sentence into words (building link-grammar's word graph for it) if
+ *  it hasn't been already, using the Dictionary's options with any +options+
+ *  applied on top. The result is kept until the sentence is released, so every
+ *  later #parse, however its options differ, re-uses it instead of tokenizing the
+ *  sentence again; that also means +options+ that only affect tokenization (e.g.,
+ *  +:spell_guessing_enabled+) have to be given here or to the first #parse.
+ *
+ *     sentence.tokenize
+ *     sentence.tokenized?                    #-> true
+ *     sentence.parse( max_null_count: 0 )    #-> 0
+ *     sentence.parse( max_null_count: 3 )    #-> 4
+ *     sentence.parse_stats[:split_time]      #-> 0.0
+ */
+static VALUE
+rlink_sentence_tokenize( int argc, VALUE *argv, VALUE self )
+{
+#ifdef HAVE_SENTENCE_SPLIT
+	struct rlink_sentence *ptr = get_sentence( self );
+	struct rlink_split_call call;
+	VALUE options = Qnil;
+
+	rb_scan_args( argc, argv, "01", &options );
+	options = rlink_dict_parse_options( ptr->dictionary, options );
+
+	/* Building the options can switch threads, so check the sentence after that */
+	ptr = get_idle_sentence( self );
+	if ( sentence_length((Sentence)ptr->sentence) > 0 ) return self;
+
+	rlink_log_obj( self, "debug", "Tokenizing sentence <%p>", ptr );
+	call.ptr = ptr;
+	call.opts = rlink_get_parseopts( options );
+	call.result = -1;
+
+	ptr->parsing = 1;
+	rb_ensure( rlink_sentence_do_split, (VALUE)&call, rlink_sentence_finish_split, (VALUE)&call );
+	RB_GC_GUARD( options );
+
+	if ( call.result != 0 )
+		rlink_raise_lp_error();
+	rlink_sentence_update_native_size( ptr );
+
+	return self;
+#else
+	rb_notimplement();
+	return Qnil;
+#endif /* HAVE_SENTENCE_SPLIT */
+}
+
+
+/*
+ *  call-seq:
+ *     sentence.tokenized?   -> true or false
+ *
+ *  Returns +true+ if the sentence has been split into words, either by #tokenize
+ *  or by parsing it.
+ */
+static VALUE
+rlink_sentence_tokenized_p( VALUE self )
+{
+	struct rlink_sentence *ptr = get_sentence( self );
 
-	return INT2FIX( link_count );
+	if ( !ptr->sentence ) return Qfalse;
+
+	/* Don't look at it while another thread might be splitting it */
+	if ( ptr->parsing ) return RTEST( ptr->parsed_p ) ? Qtrue : Qfalse;
+	return sentence_length( (Sentence)ptr->sentence ) > 0 ? Qtrue : Qfalse;
 }
 
 
@@ -250,6 +992,96 @@ rlink_sentence_parsed_p( VALUE self )
 }
 
 
+/*
+ *  call-seq:
+ *     sentence.aborted?   -> true or false
+ *
+ *  Returns +true+ if the last attempt to parse the sentence was interrupted
+ *  before it finished.
+ *
+ *     Timeout.timeout( 0.5 ) { sentence.parse } rescue nil
+ *     sentence.aborted?   #-> true
+ *     sentence.parsed?    #-> false
+ */
+static VALUE
+rlink_sentence_aborted_p( VALUE self )
+{
+	struct rlink_sentence *ptr = get_sentence( self );
+	return ptr->aborted_p;
+}
+
+
+/*
+ *  call-seq:
+ *     sentence.parsing?   -> true or false
+ *
+ *  Returns +true+ if a thread is parsing (or tokenizing) the sentence right now.
+ *  Most of the sentence's other methods raise a LinkParser::Error until it's done.
+ */
+static VALUE
+rlink_sentence_parsing_p( VALUE self )
+{
+	struct rlink_sentence *ptr = get_sentence( self );
+	return ptr->parsing ? Qtrue : Qfalse;
+}
+
+
+/*
+ *  call-seq:
+ *     sentence.release!   -> sentence
+ *
+ *  Free the link-grammar sentence and its parse set now instead of waiting for
+ *  the garbage collector. The sentence's Linkages are part of its parse set, so
+ *  they're freed with it: the sentence can't be used afterwards, and its
+ *  Linkages can only return the words, links, and disjunct strings that were
+ *  already extracted from them, so anything else needed should be fetched first.
+ *
+ *     linkage = sentence.linkages.first
+ *     words = linkage.words
+ *     sentence.release!
+ *     sentence.released?   #-> true
+ *     linkage.words        #-> same as words
+ */
+static VALUE
+rlink_sentence_release_bang( VALUE self )
+{
+	struct rlink_sentence *ptr = get_sentence( self );
+	Sentence sentence = (Sentence)ptr->sentence;
+
+	if ( ptr->parsing )
+		rb_raise( rlink_eLpError, "Sentence is being parsed by another thread" );
+
+	/* Free everything without calling back into Ruby, which could switch to a
+	   thread that starts parsing the sentence */
+	rlink_sentence_detach_linkages( ptr );
+	if ( sentence ) {
+		sentence_delete( sentence );
+		ptr->sentence = NULL;
+		rlink_sentence_update_native_size( ptr );
+	}
+	ptr->parsed_p = Qfalse;
+
+	if ( sentence )
+		rlink_log_obj( self, "debug", "Released sentence <%p>", sentence );
+
+	return self;
+}
+
+
+/*
+ *  call-seq:
+ *     sentence.released?   -> true or false
+ *
+ *  Returns +true+ if the sentence's link-grammar data has been freed with #release!.
+ */
+static VALUE
+rlink_sentence_released_p( VALUE self )
+{
+	struct rlink_sentence *ptr = get_sentence( self );
+	return ptr->sentence ? Qfalse : Qtrue;
+}
+
+
 /*
  *  call-seq:
  *     sentence.options   -> parseoptions
@@ -271,37 +1103,173 @@ rlink_sentence_options( VALUE self )
 
 /*
  *  call-seq:
- *     sentence.linkages   -> array
+ *     sentence.linkage( index )   -> LinkParser::Linkage or nil
  *
- *  Returns an Array of LinkParser::Linkage objects which represent the
- *  parts parsed from the sentence for the current linkage.
+ *  Returns the LinkParser::Linkage at +index+ in the sentence's valid linkages,
+ *  or +nil+ if there isn't one. Negative indexes count back from the last
+ *  linkage. Each Linkage is created the first time it's asked for, and the same
+ *  one is returned after that until the sentence is parsed again. Parsing it again
+ *  frees the old Linkages' link-grammar data, so they can then only return the
+ *  words, links, and disjunct strings that were already extracted from them.
  *
  */
 static VALUE
-rlink_sentence_linkages( VALUE self )
+rlink_sentence_linkage( VALUE self, VALUE index )
 {
-	struct rlink_sentence *ptr = get_sentence( self );
-	int i, count = 0;
-	VALUE rary;
+	struct rlink_sentence *ptr = get_idle_sentence( self );
+	long i = NUM2LONG( index ), count;
+	VALUE linkage;
 
 	if ( !RTEST(ptr->parsed_p) )
 		rlink_sentence_parse( 0, 0, self );
 
-	count = sentence_num_valid_linkages( (Sentence)ptr->sentence );
-	rary = rb_ary_new2( count );
+	count = rlink_sentence_linkage_count( ptr );
+	if ( i < 0 ) i += count;
+	if ( i < 0 || i >= count ) return Qnil;
 
-	for ( i = 0; i < count; i++ ) {
-		VALUE linkage;
+	if ( NIL_P(ptr->linkages) )
+		ptr->linkages = rb_ary_new2( count );
+
+	linkage = rb_ary_entry( ptr->linkages, i );
+	if ( NIL_P(linkage) ) {
 		VALUE args[2];
 
-		args[0] = INT2FIX( i );
+		args[0] = LONG2FIX( i );
 		args[1] = self;
 
 		linkage = rb_class_new_instance( 2, args, rlink_cLinkage );
-		rb_ary_store( rary, i, linkage );
+		rb_ary_store( ptr->linkages, i, linkage );
+	}
+
+	return linkage;
+}
+
+
+/*
+ *  call-seq:
+ *     sentence.freeze_result( text=nil )   -> LinkParser::ParseResult
+ *
+ *  Return a frozen LinkParser::ParseResult with the words, links, disjuncts and
+ *  costs of all of the sentence's valid linkages, parsing it first if it hasn't
+ *  been already. The result doesn't refer to the sentence or any link-grammar
+ *  data, so the sentence can be released right afterwards while the result is
+ *  kept. If +text+ is given, it's recorded as the text that was parsed.
+ *
+ *     result = sentence.freeze_result
+ *     sentence.release!
+ *     result.subject   #-> "flag"
+ */
+static VALUE
+rlink_sentence_freeze_result( int argc, VALUE *argv, VALUE self )
+{
+	struct rlink_sentence *ptr = get_idle_sentence( self );
+	Sentence sent;
+	Parse_Options opts;
+	VALUE text = Qnil, attrs, linkages;
+	long i, count;
+
+	rb_scan_args( argc, argv, "01", &text );
+
+	if ( !RTEST(ptr->parsed_p) )
+		rlink_sentence_parse( 0, 0, self );
+
+	sent = (Sentence)ptr->sentence;
+	opts = rlink_get_parseopts( ptr->options );
+	count = rlink_sentence_linkage_count( ptr );
+
+	/* Extract everything before calling any Ruby code, which could let another
+	   thread release the sentence */
+	attrs = rb_hash_new();
+	linkages = rb_ary_new2( count );
+	for ( i = 0; i < count; i++ ) {
+		Linkage linkage = linkage_create( i, sent, opts );
+		if ( !linkage ) rlink_raise_lp_error();
+
+		rb_ary_store( linkages, i, rlink_linkage_result_attrs(linkage) );
+		linkage_delete( linkage );
 	}
+	rb_hash_aset( attrs, null_count_sym, INT2FIX(sentence_null_count(sent)) );
+	rb_hash_aset( attrs, num_linkages_found_sym, INT2FIX(sentence_num_linkages_found(sent)) );
 
-	return rary;
+	if ( NIL_P(rlink_cParseResult) ) {
+		rlink_cParseResult = rb_path2class( "LinkParser::ParseResult" );
+		rlink_cParseResultLinkage = rb_path2class( "LinkParser::ParseResult::Linkage" );
+	}
+
+	for ( i = 0; i < count; i++ ) {
+		VALUE linkage_attrs = rb_ary_entry( linkages, i );
+		rb_ary_store( linkages, i, rlink_new_with_kwargs(rlink_cParseResultLinkage, linkage_attrs) );
+	}
+	rb_hash_aset( attrs, linkages_sym, linkages );
+	rb_hash_aset( attrs, text_sym, text );
+
+	return rlink_new_with_kwargs( rlink_cParseResult, attrs );
+}
+
+
+/*
+ *  call-seq:
+ *     sentence.dump( text=nil )   -> string
+ *
+ *  Return a compact, versioned binary encoding of the sentence's linkages (their
+ *  words, links, disjuncts and costs), parsing it first if it hasn't been
+ *  already. LinkParser.load turns it back into a LinkParser::ParseResult, in
+ *  this process or another one, without needing a Dictionary. If +text+ is given,
+ *  it's recorded as the text that was parsed.
+ *
+ *     data = dict.parse( "The flag was wet." ).dump
+ *     LinkParser.load( data ).subject   #-> "flag"
+ */
+static VALUE
+rlink_sentence_dump( int argc, VALUE *argv, VALUE self )
+{
+	struct rlink_sentence *ptr = get_idle_sentence( self );
+	VALUE text = Qnil;
+
+	rb_scan_args( argc, argv, "01", &text );
+	if ( !NIL_P(text) ) StringValue( text );
+
+	if ( !RTEST(ptr->parsed_p) )
+		rlink_sentence_parse( 0, 0, self );
+
+	/* Re-check the sentence, since converting the text could have run Ruby code */
+	ptr = get_idle_sentence( self );
+	return rlink_dump_sentence( (Sentence)ptr->sentence, rlink_get_parseopts(ptr->options),
+		rlink_sentence_linkage_count(ptr), text );
+}
+
+
+/*
+ *  call-seq:
+ *     sentence.parse_stats   -> hash or nil
+ *
+ *  Return a frozen Hash of statistics about the sentence's last successful parse,
+ *  or +nil+ if it hasn't been parsed. They're kept after the sentence is released.
+ *
+ *  [:split_time, :split_cpu_time]
+ *    the wall-clock and CPU seconds spent splitting the sentence into words (zero
+ *    if it had already been split by #tokenize or an earlier parse)
+ *  [:parse_time, :parse_cpu_time]
+ *    the wall-clock and CPU seconds spent parsing it, including post-processing
+ *  [:timer_expired, :memory_exhausted]
+ *    whether the parse ran out of time or memory
+ *  [:null_count, :max_null_count]
+ *    the number of null links used, and the most that were allowed
+ *  [:linkages_found, :linkages_post_processed, :valid_linkages]
+ *    the number of linkages found, post-processed, and left without violations
+ *  [:stage]
+ *    the index of the stage of an adaptive parse that the linkages are from (zero
+ *    for other parses)
+ *
+ *  The stats of every parse are also added up in LinkParser.parse_stats.
+ *
+ *     sentence.parse_stats[:parse_time]   #-> 0.0042
+ */
+static VALUE
+rlink_sentence_parse_stats( VALUE self )
+{
+	struct rlink_sentence *ptr = get_sentence( self );
+	return rlink_parse_stats_hash( &ptr->stats );
 }
 
 
@@ -310,15 +1278,16 @@ rlink_sentence_linkages( VALUE self )
  *     sentence.length   -> fixnum
  *
  *  Returns the number of words in the tokenized sentence, including the
- *  boundary words and punctuation.
+ *  boundary words and punctuation. The sentence is parsed first if it hasn't
+ *  been tokenized yet.
  *
  */
 static VALUE
 rlink_sentence_length( VALUE self )
 {
-	struct rlink_sentence *ptr = get_sentence( self );
+	struct rlink_sentence *ptr = get_idle_sentence( self );
 
-	if ( !RTEST(ptr->parsed_p) )
+	if ( !RTEST(ptr->parsed_p) && sentence_length((Sentence)ptr->sentence) == 0 )
 		rlink_sentence_parse( 0, 0, self );
 
 	return INT2FIX( sentence_length((Sentence)ptr->sentence) );
@@ -334,7 +1303,7 @@ rlink_sentence_length( VALUE self )
 static VALUE
 rlink_sentence_null_count( VALUE self )
 {
-	struct rlink_sentence *ptr = get_sentence( self );
+	struct rlink_sentence *ptr = get_idle_sentence( self );
 	int count;
 
 	if ( !RTEST(ptr->parsed_p) )
@@ -355,7 +1324,7 @@ rlink_sentence_null_count( VALUE self )
 static VALUE
 rlink_sentence_num_linkages_found( VALUE self )
 {
-	struct rlink_sentence *ptr = get_sentence( self );
+	struct rlink_sentence *ptr = get_idle_sentence( self );
 	int i = 0;
 
 	if ( !RTEST(ptr->parsed_p) )
@@ -376,13 +1345,13 @@ rlink_sentence_num_linkages_found( VALUE self )
 static VALUE
 rlink_sentence_num_valid_linkages( VALUE self )
 {
-	struct rlink_sentence *ptr = get_sentence( self );
+	struct rlink_sentence *ptr = get_idle_sentence( self );
 	int count;
 
 	if ( !RTEST(ptr->parsed_p) )
 		rlink_sentence_parse( 0, 0, self );
 
-	count = sentence_num_valid_linkages( (Sentence)ptr->sentence );
+	count = rlink_sentence_linkage_count( ptr );
 	return INT2FIX( count );
 }
 
@@ -397,7 +1366,7 @@ rlink_sentence_num_valid_linkages( VALUE self )
 static VALUE
 rlink_sentence_num_linkages_post_processed( VALUE self )
 {
-	struct rlink_sentence *ptr = get_sentence( self );
+	struct rlink_sentence *ptr = get_idle_sentence( self );
 	int count;
 
 	if ( !RTEST(ptr->parsed_p) )
@@ -418,7 +1387,7 @@ rlink_sentence_num_linkages_post_processed( VALUE self )
 static VALUE
 rlink_sentence_num_violations( VALUE self, VALUE i )
 {
-	struct rlink_sentence *ptr = get_sentence( self );
+	struct rlink_sentence *ptr = get_idle_sentence( self );
 	int count;
 
 	if ( !RTEST(ptr->parsed_p) )
@@ -438,7 +1407,7 @@ rlink_sentence_num_violations( VALUE self, VALUE i )
 static VALUE
 rlink_sentence_disjunct_cost( VALUE self, VALUE i )
 {
-	struct rlink_sentence *ptr = get_sentence( self );
+	struct rlink_sentence *ptr = get_idle_sentence( self );
 	int count;
 
 	if ( !RTEST(ptr->parsed_p) )
@@ -449,6 +1418,139 @@ rlink_sentence_disjunct_cost( VALUE self, VALUE i )
 }
 
 
+/*
+ * Hand the results of the given rlink_batch_call off to its Sentence objects
+ * and free the jobs (rb_ensure ensure).
+ */
+static VALUE
+rlink_batch_finish_parse( VALUE data )
+{
+	struct rlink_batch_call *call = (struct rlink_batch_call *)data;
+	struct rlink_batch_job *job;
+	struct rlink_sentence *ptr;
+	long i;
+
+	for ( i = 0; i < call->count; i++ ) {
+		job = &call->jobs[ i ];
+		ptr = DATA_PTR( rb_ary_entry(call->sentences, i) );
+
+		ptr->sentence = job->sentence;
+		ptr->parsing = 0;
+
+		if ( !job->done ) {
+			parse_options_set_max_parse_time( job->opts, job->max_parse_time );
+			ptr->aborted_p = Qtrue;
+		} else if ( job->sentence && job->link_count >= 0 ) {
+			rlink_parse_stats_finish( &job->stats, job->sentence, job->opts );
+			ptr->stats = job->stats;
+			ptr->options = rb_ary_entry( call->options, i );
+			ptr->parsed_p = Qtrue;
+		} else if ( call->failed < 0 ) {
+			call->failed = i;
+		}
+
+		rlink_sentence_update_native_size( ptr );
+	}
+
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_destroy( &call->lock );
+#endif
+	xfree( call->jobs );
+	call->jobs = NULL;
+
+	return Qnil;
+}
+
+
+/*
+ * Create a LinkParser::Sentence from each of the +strings+ with the given
+ * +dictionary+, and parse them with copies of +options+ (a LinkParser::ParseOptions)
+ * on up to +nthreads+ native threads without the GVL, keeping +top_k+ linkages of
+ * each (or all of them if it's 0). Returns an Array of the parsed Sentences in the
+ * same order as the +strings+.
+ */
+VALUE
+rlink_sentence_parse_batch( VALUE dictionary, VALUE strings, VALUE options, int top_k,
+	long nthreads )
+{
+	struct rlink_dictionary *dictptr = rlink_get_dict( dictionary );
+	struct rlink_batch_call call;
+	struct rlink_sentence *ptr;
+	VALUE inputs, sentences, optlist, input, sentence;
+	long i;
+
+	strings = rb_convert_type( strings, T_ARRAY, "Array", "to_ary" );
+	call.count = RARRAY_LEN( strings );
+
+	inputs = rb_ary_new2( call.count );
+	sentences = rb_ary_new2( call.count );
+	optlist = rb_ary_new2( call.count );
+
+	/* Do everything that can raise before allocating the jobs */
+	for ( i = 0; i < call.count; i++ ) {
+		input = rb_ary_entry( strings, i );
+		StringValueCStr( input );
+		rb_ary_push( inputs, rb_str_new_frozen(input) );
+		rb_ary_push( optlist, rlink_copy_parse_options(options) );
+
+		sentence = rb_obj_alloc( rlink_cSentence );
+		DATA_PTR( sentence ) = ptr = rlink_sentence_alloc();
+		ptr->dictref = rlink_dict_ref_retain( dictptr->ref );
+		ptr->dictionary = dictionary;
+		ptr->parsing = 1;
+		ptr->top_k = top_k;
+		rb_ary_push( sentences, sentence );
+	}
+
+	call.jobs = ALLOC_N( struct rlink_batch_job, call.count );
+	for ( i = 0; i < call.count; i++ ) {
+		struct rlink_batch_job *job = &call.jobs[ i ];
+
+		job->input = RSTRING_PTR( rb_ary_entry(inputs, i) );
+		job->sentence = NULL;
+		job->opts = rlink_get_parseopts( rb_ary_entry(optlist, i) );
+		job->max_parse_time = parse_options_get_max_parse_time( job->opts );
+		job->link_count = -1;
+		job->done = 0;
+		MEMZERO( &job->stats, struct rlink_parse_stats, 1 );
+	}
+
+	call.dict = dictptr->dict;
+	call.next = 0;
+	call.nthreads = nthreads < 1 ? 1 : ( nthreads > call.count ? call.count : nthreads );
+	call.failed = -1;
+	call.finished = 0;
+	call.interrupted = 0;
+	call.sentences = sentences;
+	call.options = optlist;
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_init( &call.lock, NULL );
+#endif
+
+	rlink_log( "debug", "Parsing a batch of %ld sentences with %ld threads.",
+		call.count, call.nthreads );
+	rb_ensure( rlink_batch_do_parse, (VALUE)&call, rlink_batch_finish_parse, (VALUE)&call );
+	RB_GC_GUARD( inputs );
+	RB_GC_GUARD( optlist );
+	RB_GC_GUARD( dictionary );
+
+	/* Say which input failed, since in a big batch it'd be hard to find */
+	if ( call.failed >= 0 )
+		rb_raise( rlink_eLpError, "Couldn't parse input %ld of the batch: %+"PRIsVALUE,
+			call.failed, rb_ary_entry(inputs, call.failed) );
+
+	/* Each subscriber can switch threads, so check each sentence is still there */
+	for ( i = 0; i < call.count && rlink_subscribed(RLINK_EVENT_PARSE); i++ ) {
+		ptr = DATA_PTR( rb_ary_entry(sentences, i) );
+		if ( ptr->sentence && ptr->stats.recorded )
+			rlink_sentence_publish_parse( &ptr->stats, sentence_length((Sentence)ptr->sentence), 0,
+				ptr->options );
+	}
+
+	return sentences;
+}
+
+
 /*
  * Document-class: LinkParser::Sentence
  *
@@ -457,6 +1559,10 @@ rlink_sentence_disjunct_cost( VALUE self, VALUE i )
  *   a Sentence is created and parsed, various attributes of the
  *   resulting set of linkages can be obtained.
  *
+ *   Sentences from the same Dictionary can be parsed concurrently from
+ *   different threads, but a single Sentence should only be used by one
+ *   thread at a time.
+ *
  */
 void
 rlink_init_sentence()
@@ -464,12 +1570,30 @@ rlink_init_sentence()
 	rlink_cSentence = rb_define_class_under( rlink_mLinkParser, "Sentence",
 		rb_cObject );
 
+	text_sym               = ID2SYM( rb_intern("text") );
+	null_count_sym         = ID2SYM( rb_intern("null_count") );
+	num_linkages_found_sym = ID2SYM( rb_intern("num_linkages_found") );
+	linkages_sym           = ID2SYM( rb_intern("linkages") );
+	strategy_sym           = ID2SYM( rb_intern("strategy") );
+	ladder_sym             = ID2SYM( rb_intern("ladder") );
+	single_sym             = ID2SYM( rb_intern("single") );
+	adaptive_sym           = ID2SYM( rb_intern("adaptive") );
+
 	rb_define_alloc_func( rlink_cSentence, rlink_sentence_s_alloc );
 
 	rb_define_method( rlink_cSentence, "initialize", rlink_sentence_init, 2 );
 	rb_define_method( rlink_cSentence, "parse", rlink_sentence_parse, -1 );
+	rb_define_method( rlink_cSentence, "tokenize", rlink_sentence_tokenize, -1 );
+	rb_define_method( rlink_cSentence, "tokenized?", rlink_sentence_tokenized_p, 0 );
 	rb_define_method( rlink_cSentence, "parsed?", rlink_sentence_parsed_p, 0 );
-	rb_define_method( rlink_cSentence, "linkages", rlink_sentence_linkages, 0 );
+	rb_define_method( rlink_cSentence, "aborted?", rlink_sentence_aborted_p, 0 );
+	rb_define_method( rlink_cSentence, "parsing?", rlink_sentence_parsing_p, 0 );
+	rb_define_method( rlink_cSentence, "release!", rlink_sentence_release_bang, 0 );
+	rb_define_method( rlink_cSentence, "released?", rlink_sentence_released_p, 0 );
+	rb_define_method( rlink_cSentence, "linkage", rlink_sentence_linkage, 1 );
+	rb_define_method( rlink_cSentence, "freeze_result", rlink_sentence_freeze_result, -1 );
+	rb_define_method( rlink_cSentence, "dump", rlink_sentence_dump, -1 );
+	rb_define_method( rlink_cSentence, "parse_stats", rlink_sentence_parse_stats, 0 );
 
 	rb_define_method( rlink_cSentence, "options", rlink_sentence_options, 0 );
 
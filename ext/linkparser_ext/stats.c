@@ -0,0 +1,301 @@
+/*
+ *  stats.c - Ruby LinkParser - parse timing and statistics
+ *  $Id$
+ *
+ *  Authors:
+ *    * Michael Granger <ged@FaerieMUD.org>
+ *
+ *  Please see the LICENSE file at the top of the distribution for licensing
+ *  information.
+ */
+
+#include "linkparser.h"
+
+#ifdef HAVE_CLOCK_GETTIME
+#include <time.h>
+#endif
+
+
+/* --------------------------------------------------
+ * Macros and constants
+ * -------------------------------------------------- */
+
+/* The upper bounds (in seconds) of the buckets of the process-wide timing
+   histograms; there's one more bucket for everything slower than the last */
+static const double rlink_stats_bucket_bounds[] = {
+	0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0, 2.0, 5.0, 10.0, 30.0, 60.0
+};
+#define RLINK_STATS_BUCKETS \
+	( sizeof(rlink_stats_bucket_bounds) / sizeof(rlink_stats_bucket_bounds[0]) + 1 )
+
+/* A histogram of durations */
+struct rlink_histogram {
+	unsigned long	count;
+	double			sum;
+	unsigned long	buckets[ RLINK_STATS_BUCKETS ];
+};
+
+/* The process-wide aggregate of the stats of every parse. Only updated with the
+   GVL held. */
+static struct {
+	unsigned long			parses;
+	unsigned long			timer_expired;
+	unsigned long			memory_exhausted;
+	unsigned long			with_nulls;
+	unsigned long			without_linkages;
+	struct rlink_histogram	split_time;
+	struct rlink_histogram	parse_time;
+	struct rlink_histogram	parse_cpu_time;
+} rlink_stats_totals;
+
+static VALUE split_time_sym;
+static VALUE split_cpu_time_sym;
+static VALUE parse_time_sym;
+static VALUE parse_cpu_time_sym;
+static VALUE timer_expired_sym;
+static VALUE memory_exhausted_sym;
+static VALUE null_count_sym;
+static VALUE max_null_count_sym;
+static VALUE linkages_found_sym;
+static VALUE linkages_post_processed_sym;
+static VALUE valid_linkages_sym;
+static VALUE stage_sym;
+static VALUE parses_sym;
+static VALUE with_nulls_sym;
+static VALUE without_linkages_sym;
+static VALUE count_sym;
+static VALUE sum_sym;
+static VALUE buckets_sym;
+
+
+/* --------------------------------------------------
+ * Timers
+ * -------------------------------------------------- */
+
+/*
+ * Start the given +timer+. Doesn't need the GVL.
+ */
+void
+rlink_timer_start( struct rlink_timer *timer )
+{
+#ifdef HAVE_CLOCK_GETTIME
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	timer->wall = ts.tv_sec + ts.tv_nsec / 1e9;
+# ifdef CLOCK_THREAD_CPUTIME_ID
+	clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts );
+	timer->cpu = ts.tv_sec + ts.tv_nsec / 1e9;
+# else
+	timer->cpu = 0.0;
+# endif
+#else
+	timer->wall = timer->cpu = 0.0;
+#endif /* HAVE_CLOCK_GETTIME */
+}
+
+
+/*
+ * Set +wall+ and +cpu+ to the wall-clock and CPU time in seconds since the given
+ * +timer+ was started on the current thread. Doesn't need the GVL.
+ */
+void
+rlink_timer_stop( struct rlink_timer *timer, double *wall, double *cpu )
+{
+	struct rlink_timer now;
+
+	rlink_timer_start( &now );
+	*wall = now.wall - timer->wall;
+	*cpu = now.cpu - timer->cpu;
+}
+
+
+/* --------------------------------------------------
+ * Parse stats
+ * -------------------------------------------------- */
+
+/*
+ * Add +value+ to the given +histogram+.
+ */
+static void
+rlink_histogram_add( struct rlink_histogram *histogram, double value )
+{
+	size_t i;
+
+	for ( i = 0; i < RLINK_STATS_BUCKETS - 1; i++ ) {
+		if ( value <= rlink_stats_bucket_bounds[i] ) break;
+	}
+
+	histogram->buckets[ i ]++;
+	histogram->count++;
+	histogram->sum += value;
+}
+
+
+/*
+ * Fill in the rest of the given +stats+ from the +sentence+ that was just parsed
+ * with +opts+, and add them to the process-wide totals. Must be called with the
+ * GVL held, and doesn't raise.
+ */
+void
+rlink_parse_stats_finish( struct rlink_parse_stats *stats, Sentence sentence, Parse_Options opts )
+{
+	stats->recorded                = 1;
+	stats->timer_expired           = parse_options_timer_expired( opts );
+	stats->memory_exhausted        = parse_options_memory_exhausted( opts );
+	stats->max_null_count          = parse_options_get_max_null_count( opts );
+	stats->null_count              = sentence_null_count( sentence );
+	stats->linkages_found          = sentence_num_linkages_found( sentence );
+	stats->linkages_post_processed = sentence_num_linkages_post_processed( sentence );
+	stats->valid_linkages          = sentence_num_valid_linkages( sentence );
+
+	rlink_stats_totals.parses++;
+	if ( stats->timer_expired ) rlink_stats_totals.timer_expired++;
+	if ( stats->memory_exhausted ) rlink_stats_totals.memory_exhausted++;
+	if ( stats->null_count > 0 ) rlink_stats_totals.with_nulls++;
+	if ( stats->valid_linkages == 0 ) rlink_stats_totals.without_linkages++;
+
+	/* Sentences are only split the first time they're parsed */
+	if ( stats->split_time > 0.0 )
+		rlink_histogram_add( &rlink_stats_totals.split_time, stats->split_time );
+	rlink_histogram_add( &rlink_stats_totals.parse_time, stats->parse_time );
+	rlink_histogram_add( &rlink_stats_totals.parse_cpu_time, stats->parse_cpu_time );
+}
+
+
+/*
+ * Return the given +stats+ as a frozen Hash, or nil if they haven't been
+ * recorded.
+ */
+VALUE
+rlink_parse_stats_hash( struct rlink_parse_stats *stats )
+{
+	VALUE hash;
+
+	if ( !stats->recorded ) return Qnil;
+
+	hash = rb_hash_new();
+	rb_hash_aset( hash, split_time_sym, rb_float_new(stats->split_time) );
+	rb_hash_aset( hash, split_cpu_time_sym, rb_float_new(stats->split_cpu_time) );
+	rb_hash_aset( hash, parse_time_sym, rb_float_new(stats->parse_time) );
+	rb_hash_aset( hash, parse_cpu_time_sym, rb_float_new(stats->parse_cpu_time) );
+	rb_hash_aset( hash, timer_expired_sym, stats->timer_expired ? Qtrue : Qfalse );
+	rb_hash_aset( hash, memory_exhausted_sym, stats->memory_exhausted ? Qtrue : Qfalse );
+	rb_hash_aset( hash, null_count_sym, INT2FIX(stats->null_count) );
+	rb_hash_aset( hash, max_null_count_sym, INT2FIX(stats->max_null_count) );
+	rb_hash_aset( hash, linkages_found_sym, INT2FIX(stats->linkages_found) );
+	rb_hash_aset( hash, linkages_post_processed_sym, INT2FIX(stats->linkages_post_processed) );
+	rb_hash_aset( hash, valid_linkages_sym, INT2FIX(stats->valid_linkages) );
+	rb_hash_aset( hash, stage_sym, INT2FIX(stats->stage) );
+
+	return rb_obj_freeze( hash );
+}
+
+
+/*
+ * Return the given +histogram+ as a Hash.
+ */
+static VALUE
+rlink_histogram_hash( struct rlink_histogram *histogram )
+{
+	VALUE hash = rb_hash_new(), buckets = rb_hash_new();
+	size_t i;
+
+	for ( i = 0; i < RLINK_STATS_BUCKETS; i++ ) {
+		VALUE bound = i < RLINK_STATS_BUCKETS - 1 ?
+			rb_float_new( rlink_stats_bucket_bounds[i] ) :
+			rb_const_get( rb_cFloat, rb_intern("INFINITY") );
+		rb_hash_aset( buckets, bound, ULONG2NUM(histogram->buckets[i]) );
+	}
+
+	rb_hash_aset( hash, count_sym, ULONG2NUM(histogram->count) );
+	rb_hash_aset( hash, sum_sym, rb_float_new(histogram->sum) );
+	rb_hash_aset( hash, buckets_sym, buckets );
+
+	return hash;
+}
+
+
+/*
+ *  call-seq:
+ *     LinkParser.parse_stats   -> hash
+ *
+ *  Return a Hash of the statistics of every parse the process has done (see
+ *  LinkParser::Sentence#parse_stats) since it started or LinkParser.reset_parse_stats
+ *  was last called:
+ *
+ *  [:parses]            the number of parses
+ *  [:timer_expired]     how many ran out of time
+ *  [:memory_exhausted]  how many ran out of memory
+ *  [:with_nulls]        how many needed null links
+ *  [:without_linkages]  how many found no valid linkages
+ *  [:split_time, :parse_time, :parse_cpu_time]
+ *    histograms of the parses' timings: Hashes with the <tt>:count</tt> and
+ *    <tt>:sum</tt> of the times in seconds, and <tt>:buckets</tt>, a Hash of the
+ *    number of times that were no more than each upper bound (and more than the
+ *    previous one).
+ */
+static VALUE
+rlink_s_parse_stats( VALUE module )
+{
+	VALUE hash = rb_hash_new();
+
+	rb_hash_aset( hash, parses_sym, ULONG2NUM(rlink_stats_totals.parses) );
+	rb_hash_aset( hash, timer_expired_sym, ULONG2NUM(rlink_stats_totals.timer_expired) );
+	rb_hash_aset( hash, memory_exhausted_sym, ULONG2NUM(rlink_stats_totals.memory_exhausted) );
+	rb_hash_aset( hash, with_nulls_sym, ULONG2NUM(rlink_stats_totals.with_nulls) );
+	rb_hash_aset( hash, without_linkages_sym, ULONG2NUM(rlink_stats_totals.without_linkages) );
+	rb_hash_aset( hash, split_time_sym, rlink_histogram_hash(&rlink_stats_totals.split_time) );
+	rb_hash_aset( hash, parse_time_sym, rlink_histogram_hash(&rlink_stats_totals.parse_time) );
+	rb_hash_aset( hash, parse_cpu_time_sym, rlink_histogram_hash(&rlink_stats_totals.parse_cpu_time) );
+
+	return hash;
+}
+
+
+/*
+ *  call-seq:
+ *     LinkParser.reset_parse_stats   -> nil
+ *
+ *  Reset the statistics returned by LinkParser.parse_stats to zero.
+ */
+static VALUE
+rlink_s_reset_parse_stats( VALUE module )
+{
+	memset( &rlink_stats_totals, 0, sizeof(rlink_stats_totals) );
+	return Qnil;
+}
+
+
+/*
+ * Set up the LinkParser.parse_stats functions.
+ */
+void
+rlink_init_stats()
+{
+	split_time_sym              = ID2SYM( rb_intern("split_time") );
+	split_cpu_time_sym          = ID2SYM( rb_intern("split_cpu_time") );
+	parse_time_sym              = ID2SYM( rb_intern("parse_time") );
+	parse_cpu_time_sym          = ID2SYM( rb_intern("parse_cpu_time") );
+	timer_expired_sym           = ID2SYM( rb_intern("timer_expired") );
+	memory_exhausted_sym        = ID2SYM( rb_intern("memory_exhausted") );
+	null_count_sym              = ID2SYM( rb_intern("null_count") );
+	max_null_count_sym          = ID2SYM( rb_intern("max_null_count") );
+	linkages_found_sym          = ID2SYM( rb_intern("linkages_found") );
+	linkages_post_processed_sym = ID2SYM( rb_intern("linkages_post_processed") );
+	valid_linkages_sym          = ID2SYM( rb_intern("valid_linkages") );
+	stage_sym                   = ID2SYM( rb_intern("stage") );
+	parses_sym                  = ID2SYM( rb_intern("parses") );
+	with_nulls_sym              = ID2SYM( rb_intern("with_nulls") );
+	without_linkages_sym        = ID2SYM( rb_intern("without_linkages") );
+	count_sym                   = ID2SYM( rb_intern("count") );
+	sum_sym                     = ID2SYM( rb_intern("sum") );
+	buckets_sym                 = ID2SYM( rb_intern("buckets") );
+
+	memset( &rlink_stats_totals, 0, sizeof(rlink_stats_totals) );
+
+	rb_define_singleton_method( rlink_mLinkParser, "parse_stats", rlink_s_parse_stats, 0 );
+	rb_define_singleton_method( rlink_mLinkParser, "reset_parse_stats",
+		rlink_s_reset_parse_stats, 0 );
+}
+
@@ -1,6 +1,7 @@
 # -*- ruby -*-
 # frozen_string_literal: true
 
+require 'zlib'
 require 'loggability'
 
 # The LinkParser top-level namespace.
@@ -16,6 +17,154 @@ module LinkParser
 	log_as :linkparser
 
 
+	# Logger extension that tells the extension when the logger's level changes, so
+	# it can skip formatting messages that won't be logged.
+	module LogLevelObserver
+
+		### Set the logger's level and refresh the extension's copy of it.
+		def level=( newlevel )
+			super
+			LinkParser.refresh_log_level if LinkParser.respond_to?( :refresh_log_level )
+		end
+
+	end # module LogLevelObserver
+
+
+	### Loggability API -- replace the logger, keeping the extension's copy of its
+	### level in sync.
+	def self::logger=( newlogger )
+		super
+		newlogger.extend( LogLevelObserver )
+		self.refresh_log_level if self.respond_to?( :refresh_log_level )
+	end
+
+	self.logger.extend( LogLevelObserver )
+
+
+	# The names of the events that can be subscribed to with LinkParser.subscribe
+	EVENTS = %i[ dictionary_load parse linkage ].freeze
+
+	# An instrumentation event passed to the subscribers of LinkParser.subscribe
+	Event = Struct.new( :name, :duration, :payload )
+
+	# The subscribers to each event, copied on write so publishing doesn't need the
+	# lock
+	@subscribers = {}.freeze
+	@subscribers_mutex = Mutex.new
+
+
+	### Call the block with a LinkParser::Event each time one of the given +events+
+	### (any of LinkParser::EVENTS, or all of them if none are given) happens, and
+	### return it so it can be passed to LinkParser.unsubscribe later. Each event has
+	### the +duration+ in seconds of what happened, and a frozen Hash +payload+ with
+	### details about it:
+	###
+	### [:dictionary_load]  a LinkParser::Dictionary was created: the +:language+
+	###                     asked for, and the +:outcome+ (+:success+ or +:error+)
+	### [:parse]            a Sentence was parsed: its +:length+ in words, the
+	###                     frozen Hash of +:options+ it was parsed with and their
+	###                     +:options_fingerprint+ (see
+	###                     LinkParser.options_fingerprint), the +:outcome+ (+:success+,
+	###                     +:no_linkages+, +:timeout+, +:memory_exhausted+, or
+	###                     +:error+), the number of +:linkages_found+, the
+	###                     +:null_count+, and the +:stats+ (see
+	###                     LinkParser::Sentence#parse_stats)
+	### [:linkage]          a Linkage was created: its +:index+, +:num_words+, and
+	###                     +:num_links+
+	###
+	### Subscribers are called on the thread that did the work, and any exception
+	### they raise is logged and ignored. Events that don't have any subscribers
+	### aren't built at all.
+	###
+	###    LinkParser.subscribe( :parse ) do |event|
+	###        stats.timing( "parse.#{event.payload[:outcome]}", event.duration )
+	###    end
+	def self::subscribe( *events, &block )
+		raise LocalJumpError, "no block given" unless block
+		events = EVENTS if events.empty?
+		events = events.map( &:to_sym )
+		unknown = events - EVENTS
+		raise ArgumentError, "unknown event/s: %p" % [ unknown ] unless unknown.empty?
+
+		@subscribers_mutex.synchronize do
+			subscribers = @subscribers.dup
+			events.each do |event|
+				subscribers[ event ] = ( subscribers[event] || [] ).dup.push( block ).freeze
+			end
+			@subscribers = subscribers.freeze
+			self.refresh_subscriptions
+		end
+
+		return block
+	end
+
+
+	### Stop calling the given +subscriber+ (as returned by LinkParser.subscribe)
+	### for any event. Returns +true+ if it was subscribed to any.
+	def self::unsubscribe( subscriber )
+		@subscribers_mutex.synchronize do
+			found = false
+			subscribers = @subscribers.each_with_object( {} ) do |(event, list), hash|
+				remaining = list.reject {|sub| sub.equal?(subscriber) }
+				found ||= remaining.length < list.length
+				hash[ event ] = remaining.freeze unless remaining.empty?
+			end
+			@subscribers = subscribers.freeze
+			self.refresh_subscriptions
+
+			return found
+		end
+	end
+
+
+	### Return the names of the events that have subscribers.
+	def self::subscribed_events
+		return @subscribers.keys
+	end
+
+
+	### Call the subscribers to the event called +name+ with a LinkParser::Event
+	### with the given +duration+ and +payload+. Called by the extension.
+	def self::publish_event( name, duration, payload )
+		subscribers = @subscribers[ name ] or return
+		event = Event.new( name, duration, payload ).freeze
+
+		subscribers.each do |subscriber|
+			subscriber.call( event )
+		rescue => err
+			self.log.error "%p while notifying %p of a %s event: %s" %
+				[ err.class, subscriber, name, err.message ]
+		end
+	end
+
+
+	### Return an Integer that identifies the given Hash of parse +options+. Unlike
+	### Hash#hash, it's the same in every process (and whatever order the options
+	### are in), so it can be used to match up parses across workers.
+	def self::options_fingerprint( options )
+		pairs = options.to_hash.map {|key, val| [key.to_s, val] }.sort_by( &:first )
+		return Zlib.crc32( pairs.inspect )
+	end
+
+
+	### Read the dumps written by a LinkParser::DumpWriter (or any concatenation of
+	### LinkParser::Sentence#dump Strings) from +io+ and yield each one to the block
+	### as a LinkParser::ParseResult. Returns an Enumerator if no block is given.
+	def self::load_each( io )
+		return enum_for( __method__, io ) unless block_given?
+
+		while ( header = io.read(DUMP_HEADER_LENGTH) )
+			body_length = self.dump_length( header ) - header.bytesize
+			body = io.read( body_length ) || ''
+			raise LinkParser::Error, "truncated LinkParser dump" if body.bytesize < body_length
+
+			yield self.load( header + body )
+		end
+
+		return io
+	end
+
+
 	# Load the correct version if it's a Windows binary gem
 	if RUBY_PLATFORM =~/(mswin|mingw)/i
 		major_minor = RUBY_VERSION[ /^(\d+\.\d+)/ ] or
@@ -34,7 +183,11 @@ module LinkParser
 	require 'linkparser/dictionary'
 	require 'linkparser/sentence'
 	require 'linkparser/linkage'
+	require 'linkparser/linkagelist'
 	require 'linkparser/parseoptions'
+	require 'linkparser/parseresult'
+	require 'linkparser/parsecache'
+	require 'linkparser/dumpwriter'
 
 
 end # class LinkParser
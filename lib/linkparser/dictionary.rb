@@ -9,5 +9,173 @@ class LinkParser::Dictionary
 	# Use LinkParser's logger
 	log_to :linkparser
 
+
+	# The number of sentences #each_parse parses at a time by default
+	DEFAULT_PARSE_BATCH_SIZE = 64
+
+	# The number of batches #each_parse reads ahead of the one being parsed by
+	# default
+	DEFAULT_PARSE_WINDOW = 2
+
+
+	# The Dictionaries returned by ::shared, keyed by language
+	@shared = {}
+	@shared_mutex = Mutex.new
+
+
+	### Return the Dictionary for +lang+ (or for the current environment's language
+	### if +lang+ is nil) that's shared by the whole process, loading it the first
+	### time it's asked for. Loading a dictionary is slow and uses a lot of memory,
+	### so this should be preferred to ::new when the same language is used in more
+	### than one place. It's safe to call from multiple threads.
+	###
+	### If any +options+ are given, the returned Dictionary uses the shared one's
+	### link-grammar data, but has them as its default parse options (see
+	### #with_options).
+	###
+	###    dict = LinkParser::Dictionary.shared( :en, max_null_count: 3 )
+	def self::shared( lang=nil, **options )
+		key = lang ? lang.to_s : :default
+		dict = @shared_mutex.synchronize do
+			@shared[ key ] ||= begin
+				self.log.info "Loading the shared %s dictionary" % [ lang || 'default' ]
+				lang ? self.new( lang.to_s ) : self.new
+			end
+		end
+
+		return dict if options.empty?
+		return dict.with_options( **options )
+	end
+
+
+	### Load the shared Dictionaries (see ::shared) for each of the given +langs+
+	### (or the default language if none are given) now. Calling this in a server's
+	### master process before it forks its workers lets them all share the
+	### dictionaries' memory copy-on-write instead of each loading their own.
+	### Returns the Dictionaries.
+	###
+	###    # config/puma.rb
+	###    before_fork { LinkParser::Dictionary.preload(:en) }
+	def self::preload( *langs )
+		langs = [ nil ] if langs.empty?
+		return langs.map {|lang| self.shared(lang) }
+	end
+
+
+	##
+	# The LinkParser::ParseCache #parse_result uses, if any
+	attr_accessor :parse_cache
+
+
+	### Parse +text+ and return the results as a frozen LinkParser::ParseResult,
+	### releasing the Sentence it came from. Any +options+ override the
+	### Dictionary's. If the Dictionary has a #parse_cache, the result is looked up
+	### there first (by the text, the #effective_options, so options that come to the
+	### same thing share results, and the +:top_k+), and only parsed (and stored) if it
+	### isn't found.
+	def parse_result( text, **options )
+		cache = self.parse_cache or return self.make_parse_result( text, options )
+		effective = self.effective_options( options ).to_hash
+		effective = effective.merge( top_k: options[:top_k] ) if options[:top_k]
+
+		return cache.fetch( text, effective ) do
+			self.make_parse_result( text, options )
+		end
+	end
+
+
+	### Return a copy of the Dictionary that shares its link-grammar data but
+	### uses the given +options+ merged over its own as its default parse options.
+	def with_options( **options )
+		copy = self.dup
+		copy.options = self.options.merge( options )
+		return copy
+	end
+
+
+	### Parse sentences read from the given +io+, one per line (or one per paragraph
+	### if +paragraphs+ is true), and yield each resulting LinkParser::Sentence to the
+	### block in the order they were read. Input is read in batches of +batch+
+	### sentences by a separate thread while the previous batch is parsed with
+	### #parse_batch using +threads+ native threads, and at most +window+ batches are
+	### read ahead, so memory use stays the same no matter how big the input is.
+	###
+	### Each Sentence is released (see LinkParser::Sentence#release!) when the block
+	### returns unless +release+ is false, so anything needed from it should be
+	### extracted inside the block. Any other +options+ override the Dictionary's
+	### for every sentence. Returns an Enumerator if no block is given.
+	def each_parse( io, batch: DEFAULT_PARSE_BATCH_SIZE, threads: nil,
+		window: DEFAULT_PARSE_WINDOW, paragraphs: false, release: true, **options, &block )
+
+		unless block
+			return enum_for( __method__, io, batch: batch, threads: threads, window: window,
+				paragraphs: paragraphs, release: release, **options )
+		end
+
+		options[ :threads ] = threads if threads
+		queue = SizedQueue.new( window )
+		reader = Thread.new do
+			Thread.current.report_on_exception = false
+			self.read_batches( io, batch, paragraphs ) {|lines| queue.push(lines) }
+		ensure
+			queue.close
+		end
+
+		while lines = queue.pop
+			self.log.debug "Parsing a batch of %d sentences" % [ lines.length ]
+			self.parse_batch( lines, **options ).each do |sentence|
+				yield( sentence )
+				sentence.release! if release
+			end
+		end
+
+		reader.value
+		return nil
+	ensure
+		queue&.close
+		reader.kill if reader&.alive?
+	end
+
+
+	#########
+	protected
+	#########
+
+	##
+	# Replace the Dictionary's default parse options
+	attr_writer :options
+
+
+	### Parse +text+ with the given +options+ and return a LinkParser::ParseResult
+	### of it.
+	def make_parse_result( text, options )
+		sentence = self.parse( text, options )
+		return sentence.freeze_result( text )
+	ensure
+		sentence&.release!
+	end
+
+
+	### Read sentences from the given +io+ and yield them in Arrays of up to
+	### +batch_size+. If +paragraphs+ is true, each run of non-blank lines is one
+	### sentence; otherwise each line is. Blank sentences are skipped.
+	def read_batches( io, batch_size, paragraphs )
+		separator = paragraphs ? '' : $/
+		lines = []
+
+		io.each_line( separator ) do |line|
+			line = line.strip
+			next if line.empty?
+
+			lines << ( paragraphs ? line.gsub(/\s+/, ' ') : line )
+			if lines.length >= batch_size
+				yield( lines )
+				lines = []
+			end
+		end
+
+		yield( lines ) unless lines.empty?
+	end
+
 end # class LinkParser::Dictionary
 
@@ -0,0 +1,86 @@
+# -*- ruby -*-
+# frozen_string_literal: true
+
+require 'linkparser' unless defined?( LinkParser )
+
+
+# Writes a stream of parsed sentences to an IO in the binary encoding of
+# LinkParser::Sentence#dump, for handing them off to another process. Read them
+# back with LinkParser.load_each:
+#
+#    File.open( 'parses.lpr', 'wb' ) do |io|
+#        writer = LinkParser::DumpWriter.new( io )
+#        texts.each {|text| writer.write(dict.parse(text), text) }
+#    end
+#
+#    File.open( 'parses.lpr', 'rb' ) do |io|
+#        LinkParser.load_each( io ) {|result| puts result.subject }
+#    end
+#
+class LinkParser::DumpWriter
+	extend Loggability
+
+	# Use LinkParser's logger
+	log_to :linkparser
+
+
+	### Create a new writer that writes to the given +io+, which should be in
+	### binary mode.
+	def initialize( io )
+		@io    = io
+		@count = 0
+		@bytes = 0
+	end
+
+
+	######
+	public
+	######
+
+	##
+	# The IO the dumps are written to
+	attr_reader :io
+
+	##
+	# The number of dumps written so far
+	attr_reader :count
+
+	##
+	# The number of bytes written so far
+	attr_reader :bytes
+
+
+	### Write the dump of the given +sentence+ (parsing it first if it hasn't been
+	### already), recording +text+ as the text that was parsed if it's given.
+	### +sentence+ can also be a String returned by LinkParser::Sentence#dump.
+	### Returns the number of bytes written.
+	def write( sentence, text=nil )
+		data = sentence.is_a?( String ) ? sentence : sentence.dump( text )
+		written = self.io.write( data )
+
+		@count += 1
+		@bytes += written
+
+		return written
+	end
+
+
+	### Write the dump of the given +sentence+ and return the writer, so calls can
+	### be chained.
+	def <<( sentence )
+		self.write( sentence )
+		return self
+	end
+
+
+	### Return a human-readable representation of the writer.
+	def inspect
+		return "#<%s:%#x %d dumps, %d bytes>" % [
+			self.class.name,
+			self.object_id / 2,
+			self.count,
+			self.bytes,
+		]
+	end
+
+end # class LinkParser::DumpWriter
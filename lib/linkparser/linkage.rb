@@ -9,6 +9,7 @@ require 'linkparser/mixins'
 class LinkParser::Linkage
 	extend Loggability,
 	       LinkParser::DeprecationUtilities
+	include LinkParser::LinkageQueries
 
 	# Use LinkParser's logger
 	log_to :linkparser
@@ -37,103 +38,6 @@ class LinkParser::Linkage
 		]
 	end
 
-
-	### Return the +index+th link.
-	def link( index )
-		Link.new(
-			self.words[ self.link_lword(index) ],
-			self.words[ self.link_rword(index) ],
-			self.link_length(index),
-			self.link_label(index),
-			self.link_llabel(index),
-			self.link_rlabel(index),
-			LINK_TYPES[ self.link_label(index).gsub(/[^A-Z]+/, '') ]
-		)
-	end
-
-
-	### Return the Array of words in the sentence as tokenized by the
-	### parser.
-	def links
-		return ( 0...self.link_count ).collect do |i|
-			self.link( i )
-		end
-	end
-
-
-	### Return an Array of parsed (well, just split on whitespace for now) disjunct strings
-	### for the linkage.
-	def disjuncts
-		return self.disjunct_strings.collect do |dstr|
-			if dstr.nil?
-				nil
-			else
-				dstr.split
-			end
-		end
-	end
-
-
-	### Return the verb word from the linkage.
-	def verb( keep_subscript: false )
-		word = if verblink = self.links.find {|link| link.llabel =~ /^(O([DFNTX]?)|P|BI|K|LI|MV|Q)[a-z\*]*/ }
-				verblink.lword
-			elsif verblink = self.links.find {|link| link.rlabel =~ /^(SI|S|AF)[a-z\*]*/ }
-				verblink.rword
-			else
-				nil
-			end
-
-		return with_subscript( word, keep_subscript )
-	end
-
-
-	### Return the subject from the linkage.
-	def subject( keep_subscript: false )
-		subjlink = self.links.find {|link| link.llabel[0] == ?S } or return nil
-		return with_subscript( subjlink.lword, keep_subscript )
-	end
-
-
-	### Return the object from the linkage.
-	def object( keep_subscript: false )
-		objlink = self.links.find {|link| link.rlabel[0] == ?O } or return nil
-		return with_subscript( objlink.rword, keep_subscript )
-	end
-
-
-	### Return an Array of all the nouns in the linkage.
-	def nouns
-		nouns = []
-		self.links.each do |link|
-			nouns << $1 if link.lword =~ /^(.*)\.n(?:-\w)?$/
-			nouns << $1 if link.rword =~ /^(.*)\.n(?:-\w)?$/
-		end
-
-		return nouns.uniq
-	end
-
-
-	### Returns +true+ if the linkage indicates the sentence is phrased in the
-	### imperative voice.
-	def imperative?
-		return self.links.find {|link| link.label == 'Wi' && link.rword =~ /\.v$/ } ?
-			true : false
-	end
-
-
-	#######
-	private
-	#######
-
-
-	### Return the specified +word+ with the part-of-speech subscript removed.
-	def with_subscript( word, keep_subscript )
-		return unless word
-		return word if keep_subscript
-		return word.sub( /\.[\p{alpha}\-]+$/, '' )
-	end
-
 end # class Sentence
 
 
@@ -0,0 +1,110 @@
+# -*- ruby -*-
+# frozen_string_literal: true
+
+require 'linkparser' unless defined?( LinkParser )
+
+
+# The collection of linkages of a LinkParser::Sentence, as returned by
+# LinkParser::Sentence#linkages. The LinkParser::Linkage objects in it are only
+# created when they're asked for, so looking at just the first one (the best
+# parse) doesn't pay for building all the rest.
+class LinkParser::LinkageList
+	extend Loggability
+	include Enumerable
+
+	# Use LinkParser's logger
+	log_to :linkparser
+
+
+	### Create a new LinkageList for the linkages of the given +sentence+.
+	def initialize( sentence )
+		@sentence = sentence
+	end
+
+
+	######
+	public
+	######
+
+	##
+	# The LinkParser::Sentence the linkages belong to
+	attr_reader :sentence
+
+
+	### Return the number of linkages in the list.
+	def size
+		return self.sentence.num_valid_linkages
+	end
+	alias_method :length, :size
+
+
+	### Returns +true+ if the sentence has no valid linkages.
+	def empty?
+		return self.size.zero?
+	end
+
+
+	### Element reference -- return the Linkage at +index+, or an Array of the
+	### Linkages for a +start+ and +length+ or a Range, just like Array#[].
+	def []( index, length=nil )
+		if length || index.is_a?( Range )
+			indexes = ( 0...self.size ).to_a[ *[index, length].compact ] or return nil
+			return indexes.map {|i| self.sentence.linkage(i) }
+		end
+
+		return self.sentence.linkage( index )
+	end
+
+
+	### Return the first Linkage, or an Array of the first +count+ Linkages if
+	### +count+ is given.
+	def first( count=nil )
+		return self[ 0 ] unless count
+		raise ArgumentError, "negative array size" if count.negative?
+		return self[ 0, count ]
+	end
+
+
+	### Return the last Linkage, or an Array of the last +count+ Linkages if
+	### +count+ is given.
+	def last( count=nil )
+		return self[ -1 ] unless count
+		raise ArgumentError, "negative array size" if count.negative?
+
+		size = self.size
+		count = size if count > size
+		return self[ size - count, count ]
+	end
+
+
+	### Yield each Linkage to the block, creating them as they're needed. Returns
+	### an Enumerator if no block is given.
+	def each
+		return enum_for( __method__ ) { self.size } unless block_given?
+
+		self.size.times do |i|
+			yield( self.sentence.linkage(i) )
+		end
+
+		return self
+	end
+
+
+	### Write the link tables of all of the linkages into packed integer columns
+	### with LinkParser::Linkage.pack_links, adding their labels to +labels+.
+	def pack_links( labels={} )
+		return LinkParser::Linkage.pack_links( self.to_a, labels )
+	end
+
+
+	### Return a human-readable representation of the LinkageList.
+	def inspect
+		return %{#<%s:0x%x: [%d linkages]>} % [
+			self.class.name,
+			self.object_id / 2,
+			self.size
+		]
+	end
+
+end # class LinkParser::LinkageList
+
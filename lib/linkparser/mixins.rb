@@ -34,4 +34,84 @@ module LinkParser
 
 	end # module DeprecationUtilities
 
+	### Methods for querying the words and links of a linkage. They only need
+	### #links and #disjunct_strings, so they're shared by LinkParser::Linkage and
+	### LinkParser::ParseResult::Linkage.
+	module LinkageQueries
+
+		### Return an Array of parsed (well, just split on whitespace for now) disjunct strings
+		### for the linkage.
+		def disjuncts
+			return self.disjunct_strings.collect do |dstr|
+				if dstr.nil?
+					nil
+				else
+					dstr.split
+				end
+			end
+		end
+
+
+		### Return the verb word from the linkage.
+		def verb( keep_subscript: false )
+			word = if verblink = self.links.find {|link| link.llabel =~ /^(O([DFNTX]?)|P|BI|K|LI|MV|Q)[a-z\*]*/ }
+					verblink.lword
+				elsif verblink = self.links.find {|link| link.rlabel =~ /^(SI|S|AF)[a-z\*]*/ }
+					verblink.rword
+				else
+					nil
+				end
+
+			return with_subscript( word, keep_subscript )
+		end
+
+
+		### Return the subject from the linkage.
+		def subject( keep_subscript: false )
+			subjlink = self.links.find {|link| link.llabel[0] == ?S } or return nil
+			return with_subscript( subjlink.lword, keep_subscript )
+		end
+
+
+		### Return the object from the linkage.
+		def object( keep_subscript: false )
+			objlink = self.links.find {|link| link.rlabel[0] == ?O } or return nil
+			return with_subscript( objlink.rword, keep_subscript )
+		end
+
+
+		### Return an Array of all the nouns in the linkage.
+		def nouns
+			nouns = []
+			self.links.each do |link|
+				nouns << $1 if link.lword =~ /^(.*)\.n(?:-\w)?$/
+				nouns << $1 if link.rword =~ /^(.*)\.n(?:-\w)?$/
+			end
+
+			return nouns.uniq
+		end
+
+
+		### Returns +true+ if the linkage indicates the sentence is phrased in the
+		### imperative voice.
+		def imperative?
+			return self.links.find {|link| link.label == 'Wi' && link.rword =~ /\.v$/ } ?
+				true : false
+		end
+
+
+		#######
+		private
+		#######
+
+
+		### Return the specified +word+ with the part-of-speech subscript removed.
+		def with_subscript( word, keep_subscript )
+			return unless word
+			return word if keep_subscript
+			return word.sub( /\.[\p{alpha}\-]+$/, '' )
+		end
+
+	end # module LinkageQueries
+
 end # module LinkParser
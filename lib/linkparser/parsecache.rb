@@ -0,0 +1,185 @@
+# -*- ruby -*-
+# frozen_string_literal: true
+
+require 'linkparser' unless defined?( LinkParser )
+
+
+# A bounded, thread-safe least-recently-used cache of LinkParser::ParseResults,
+# keyed by normalized sentence text and the options it was parsed with. Set one
+# as a Dictionary's #parse_cache to make LinkParser::Dictionary#parse_result use
+# it:
+#
+#    dict.parse_cache = LinkParser::ParseCache.new( max_entries: 50_000 )
+#    result = dict.parse_result( "The cat runs." )
+#    dict.parse_cache.stats  # => {entries: 1, bytes: ..., hits: 0, misses: 1, ...}
+#
+class LinkParser::ParseCache
+	extend Loggability
+
+	# Use LinkParser's logger
+	log_to :linkparser
+
+
+	# The maximum number of results kept by default
+	DEFAULT_MAX_ENTRIES = 10_000
+
+	# The maximum total estimated size of the kept results by default, in bytes
+	DEFAULT_MAX_BYTES = 64 * 1024 * 1024
+
+
+	### Return the normalized form of +text+ used for cache keys -- leading and
+	### trailing whitespace removed, and all other runs of whitespace collapsed to
+	### a single space.
+	def self::normalize( text )
+		return text.to_s.strip.gsub( /\s+/, ' ' )
+	end
+
+
+	### Create a new cache that keeps at most +max_entries+ results, whose
+	### LinkParser::ParseResult#estimated_size adds up to at most +max_bytes+.
+	def initialize( max_entries: DEFAULT_MAX_ENTRIES, max_bytes: DEFAULT_MAX_BYTES )
+		@max_entries = Integer( max_entries )
+		@max_bytes   = Integer( max_bytes )
+
+		@entries     = {}
+		@bytes       = 0
+		@hits        = 0
+		@misses      = 0
+		@evictions   = 0
+		@mutex       = Mutex.new
+	end
+
+
+	######
+	public
+	######
+
+	##
+	# The maximum number of results the cache keeps
+	attr_reader :max_entries
+
+	##
+	# The maximum total estimated size of the results the cache keeps
+	attr_reader :max_bytes
+
+	##
+	# The number of lookups that found a result
+	attr_reader :hits
+
+	##
+	# The number of lookups that didn't find a result
+	attr_reader :misses
+
+	##
+	# The number of results that were dropped to make room for newer ones
+	attr_reader :evictions
+
+	##
+	# The total estimated size of the results in the cache
+	attr_reader :bytes
+
+
+	### Return the cached result for +text+ parsed with the given +options+ (a Hash
+	### of the effective parse options). If there isn't one, call the block with
+	### the normalized text to create it, store what it returns, and return that.
+	def fetch( text, options={} )
+		key = self.make_key( text, options )
+
+		result = @mutex.synchronize do
+			if ( cached = @entries.delete(key) )
+				@entries[ key ] = cached
+				@hits += 1
+			else
+				@misses += 1
+			end
+			cached
+		end
+		return result if result || !block_given?
+
+		result = yield( key.first )
+		self.store( key, result )
+
+		return result
+	end
+
+
+	### Return the number of results in the cache.
+	def size
+		return @mutex.synchronize { @entries.size }
+	end
+	alias_method :length, :size
+
+
+	### Remove all results from the cache. The counters aren't reset.
+	def clear
+		@mutex.synchronize do
+			@entries.clear
+			@bytes = 0
+		end
+	end
+
+
+	### Return a Hash of the cache's counters and limits.
+	def stats
+		return @mutex.synchronize do
+			{
+				entries: @entries.size,
+				bytes: @bytes,
+				hits: @hits,
+				misses: @misses,
+				evictions: @evictions,
+				max_entries: @max_entries,
+				max_bytes: @max_bytes,
+			}
+		end
+	end
+
+
+	### Return a human-readable representation of the cache.
+	def inspect
+		stats = self.stats
+		return "#<%s:%#x %d/%d entries, %d/%d bytes, %d hits, %d misses, %d evictions>" % [
+			self.class.name,
+			self.object_id / 2,
+			stats[:entries], stats[:max_entries],
+			stats[:bytes], stats[:max_bytes],
+			stats[:hits], stats[:misses], stats[:evictions],
+		]
+	end
+
+
+	#########
+	protected
+	#########
+
+	### Return the cache key for +text+ parsed with +options+.
+	def make_key( text, options )
+		return [ self.class.normalize(text).freeze, options.dup.freeze ].freeze
+	end
+
+
+	### Store +result+ under +key+, evicting the least-recently-used results until
+	### the cache is within its limits again. Results bigger than the whole cache
+	### aren't stored.
+	def store( key, result )
+		size = result.respond_to?( :estimated_size ) ? result.estimated_size : 0
+		return if size > @max_bytes || @max_entries < 1
+
+		@mutex.synchronize do
+			if ( old = @entries.delete(key) )
+				@bytes -= old.estimated_size if old.respond_to?( :estimated_size )
+			end
+
+			@entries[ key ] = result
+			@bytes += size
+
+			while @entries.size > @max_entries || @bytes > @max_bytes
+				_, evicted = @entries.shift
+				@bytes -= evicted.estimated_size if evicted.respond_to?( :estimated_size )
+				@evictions += 1
+			end
+		end
+	end
+
+end # class LinkParser::ParseCache
+
@@ -0,0 +1,227 @@
+# -*- ruby -*-
+# frozen_string_literal: true
+
+require 'linkparser' unless defined?( LinkParser )
+require 'linkparser/mixins'
+
+
+# A frozen, self-contained copy of the results of parsing a LinkParser::Sentence,
+# as returned by LinkParser::Sentence#freeze_result.
+# Unlike a Sentence and its Linkages, it doesn't refer to any link-grammar data,
+# so it can be kept (e.g., in a LinkParser::ParseCache) without keeping the
+# Sentence alive. Methods that LinkParser::Sentence delegates to its first
+# linkage, like #verb and #subject, are delegated the same way.
+class LinkParser::ParseResult
+	extend Loggability
+
+	# Use LinkParser's logger
+	log_to :linkparser
+
+
+	# The approximate size of a Ruby object, used by #estimated_size
+	OBJECT_SIZE = 40
+
+
+	# A frozen copy of a LinkParser::Linkage, as returned by
+	# LinkParser::Linkage#to_result
+	class Linkage
+		include LinkParser::LinkageQueries
+
+		### Create a new Linkage with the given values. Linkages are usually
+		### created with LinkParser::Linkage#to_result instead of directly.
+		def initialize( words:, links:, disjunct_strings:, unused_word_cost:, disjunct_cost:,
+			link_cost:, violation_name: nil )
+
+			@words            = LinkParser::ParseResult.deep_freeze( words )
+			@links            = LinkParser::ParseResult.deep_freeze( links )
+			@disjunct_strings = LinkParser::ParseResult.deep_freeze( disjunct_strings )
+			@unused_word_cost = unused_word_cost
+			@disjunct_cost    = disjunct_cost
+			@link_cost        = link_cost
+			@violation_name   = violation_name&.dup&.freeze
+
+			self.freeze
+		end
+
+
+		######
+		public
+		######
+
+		##
+		# The Array of the linkage's words, e.g., "dog.n"
+		attr_reader :words
+
+		##
+		# The Array of the linkage's LinkParser::Linkage::Link structs
+		attr_reader :links
+
+		##
+		# The disjuncts used for each of the linkage's words
+		attr_reader :disjunct_strings
+
+		##
+		# The linkage's costs (see LinkParser::Linkage)
+		attr_reader :unused_word_cost, :disjunct_cost, :link_cost
+
+		##
+		# The name of the post-processing rule the linkage violated, if any
+		attr_reader :violation_name
+
+
+		### Return the number of words in the linkage.
+		def num_words
+			return self.words.length
+		end
+		alias_method :word_count, :num_words
+
+
+		### Return the number of links in the linkage.
+		def num_links
+			return self.links.length
+		end
+		alias_method :link_count, :num_links
+
+
+		### Return a human-readable representation of the Linkage.
+		def inspect
+			return %{#<%s:0x%x: [%d links]>} % [
+				self.class.name,
+				self.object_id / 2,
+				self.num_links
+			]
+		end
+
+	end # class Linkage
+
+
+	### Freeze the given +object+ and, if it's an Array or Struct, everything in it.
+	### Returns the object.
+	def self::deep_freeze( object )
+		case object
+		when Array, Struct
+			object.each {|member| deep_freeze(member) } unless object.frozen?
+		end
+
+		return object.freeze
+	end
+
+
+	### Create a new ParseResult with the given values. If +words+ isn't given,
+	### the first linkage's are used, and if +text+ isn't given, it's the words
+	### joined with spaces. Results are usually created with
+	### LinkParser::Sentence#freeze_result instead of directly.
+	def initialize( null_count:, num_linkages_found:, linkages:, text: nil, words: nil )
+		words             ||= linkages.empty? ? [] : linkages.first.words
+		@words              = self.class.deep_freeze( words.dup )
+		@text               = ( text || @words.join(" ") ).dup.freeze
+		@null_count         = null_count
+		@num_linkages_found = num_linkages_found
+		@linkages           = linkages.dup.freeze
+		@estimated_size     = self.calculate_size
+
+		self.freeze
+	end
+
+
+	######
+	public
+	######
+
+	##
+	# The text that was parsed
+	attr_reader :text
+
+	##
+	# The Array of the sentence's tokenized words (those of its first linkage, like
+	# LinkParser::Sentence#words), or an empty Array if it has no linkages
+	attr_reader :words
+
+	##
+	# The number of null links that were used in parsing the sentence
+	attr_reader :null_count
+
+	##
+	# The number of linkages found when parsing the sentence
+	attr_reader :num_linkages_found
+
+	##
+	# The Array of ParseResult::Linkages of the sentence's valid linkages
+	attr_reader :linkages
+
+	##
+	# The approximate number of bytes used by the result
+	attr_reader :estimated_size
+
+
+	### Return the number of valid linkages.
+	def num_valid_linkages
+		return self.linkages.length
+	end
+
+
+	### Return the number of words in the sentence.
+	def length
+		return self.words.length
+	end
+
+
+	### Results are always parsed.
+	def parsed?
+		return true
+	end
+
+
+	### Return the sentence's words joined with spaces.
+	def to_s
+		return self.words.join( " " )
+	end
+
+
+	### Return a human-readable representation of the ParseResult.
+	def inspect
+		return %{#<%s:%#x "%s"/%d linkages/%d nulls>} % [
+			self.class.name,
+			self.object_id / 2,
+			self.to_s,
+			self.num_linkages_found,
+			self.null_count,
+		]
+	end
+
+
+	# Delegate the query methods to the first linkage, like LinkParser::Sentence does
+	( LinkParser::LinkageQueries.public_instance_methods +
+	  %i[links disjunct_strings num_links link_count unused_word_cost disjunct_cost link_cost] ).
+		each do |name|
+			define_method( name ) do |*args, **kwargs, &block|
+				linkage = self.linkages.first or raise LinkParser::Error, "sentence has no linkages"
+				linkage.public_send( name, *args, **kwargs, &block )
+			end
+		end
+
+
+	#########
+	protected
+	#########
+
+	### Return an estimate of how much memory the result uses in bytes.
+	def calculate_size
+		size = OBJECT_SIZE * ( 2 + self.words.length ) + self.text.bytesize +
+			self.words.sum( &:bytesize )
+
+		self.linkages.each do |linkage|
+			size += OBJECT_SIZE * ( 4 + linkage.words.length + linkage.disjunct_strings.length )
+			size += linkage.words.sum( &:bytesize )
+			size += linkage.disjunct_strings.sum {|dstr| dstr ? dstr.bytesize : 0 }
+			linkage.links.each do |link|
+				size += OBJECT_SIZE * 4 +
+					link.label.to_s.bytesize + link.llabel.to_s.bytesize + link.rlabel.to_s.bytesize
+			end
+		end
+
+		return size
+	end
+
+end # class LinkParser::ParseResult
+
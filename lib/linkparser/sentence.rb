@@ -12,6 +12,16 @@ class LinkParser::Sentence
 	log_to :linkparser
 
 
+	# The stages of a <tt>parse( strategy: :adaptive )</tt> if no +ladder+ is given:
+	# a quick parse without null links, then one that allows a few, then a slower
+	# one with higher costs and as many nulls as it takes.
+	ADAPTIVE_LADDER = [
+		{ min_null_count: 0, max_null_count: 0 },
+		{ min_null_count: 1, max_null_count: 3 },
+		{ min_null_count: 1, max_null_count: 250, disjunct_cost: 4.0, max_parse_time: 30 },
+	].each( &:freeze ).freeze
+
+
 	######
 	public
 	######
@@ -25,6 +35,10 @@ class LinkParser::Sentence
 				self.num_linkages_found,
 				self.null_count,
 			]
+		elsif self.released?
+			contents = "(released)"
+		elsif self.aborted?
+			contents = "(aborted)"
 		else
 			contents = "(unparsed)"
 		end
@@ -37,6 +51,15 @@ class LinkParser::Sentence
 	end
 
 
+	### Return a LinkParser::LinkageList of the sentence's linkages, parsing it
+	### first if it hasn't been already. The Linkages in it are only created when
+	### they're used.
+	def linkages
+		self.parse unless self.parsed?
+		return LinkParser::LinkageList.new( self )
+	end
+
+
 	### Print out the sentence
 	def to_s
 		return self.words.join(" ")
@@ -4,6 +4,8 @@
 require_relative '../helpers'
 
 require 'rspec'
+require 'stringio'
+require 'objspace'
 require 'linkparser'
 
 
@@ -60,6 +62,38 @@ describe LinkParser::Dictionary do
 	end
 
 
+	it "loads each language only once for the shared registry" do
+		dict = LinkParser::Dictionary.shared( :en )
+
+		expect( dict ).to be_a( LinkParser::Dictionary )
+		expect( LinkParser::Dictionary.shared('en') ).to equal( dict )
+		expect( LinkParser::Dictionary.preload(:en) ).to eq( [dict] )
+	end
+
+	it "can return a shared dictionary with its own options" do
+		dict = LinkParser::Dictionary.shared( :en )
+		derived = LinkParser::Dictionary.shared( :en, max_null_count: 4 )
+
+		expect( derived ).to_not equal( dict )
+		expect( derived.options[:max_null_count] ).to eq( 4 )
+		expect( dict.options ).to_not include( :max_null_count )
+		expect( derived.parse("The cat runs.").options.max_null_count ).to eq( 4 )
+	end
+
+	it "returns the same shared dictionary from concurrent threads" do
+		threads = 4.times.map { Thread.new { LinkParser::Dictionary.shared(:en) } }
+		expect( threads.map(&:value).uniq.length ).to eq( 1 )
+	end
+
+	it "counts the memory of its link-grammar dictionary once, in the dictionary that loaded it" do
+		dict = LinkParser::Dictionary.shared( :en )
+		derived = LinkParser::Dictionary.shared( :en, max_null_count: 4 )
+
+		expect( ObjectSpace.memsize_of(dict) ).to be > 1024 * 1024
+		expect( ObjectSpace.memsize_of(derived) ).to be < 1024
+	end
+
+
 	context "instance" do
 
 		TEST_SENTENCE = "The dog plays with the ball."
@@ -80,6 +114,73 @@ describe LinkParser::Dictionary do
 			expect( sentence.options.verbosity ).to eq( 0 )
 			expect( sentence.options.islands_ok? ).to eq( true )
 		end
+
+		it "gives each sentence its own copy of the options it was parsed with" do
+			first = @dict.parse( TEST_SENTENCE, max_null_count: 3 )
+			first.options.max_null_count = 7
+			second = @dict.parse( TEST_SENTENCE, max_null_count: 3 )
+
+			expect( second.options ).to_not equal( first.options )
+			expect( second.options.max_null_count ).to eq( 3 )
+		end
+
+		it "uses its current options even after they've been changed" do
+			dict = LinkParser::Dictionary.new( verbosity: 0, max_null_count: 18 )
+			expect( dict.parse(TEST_SENTENCE).options.max_null_count ).to eq( 18 )
+
+			dict.options[ :max_null_count ] = 5
+			expect( dict.parse(TEST_SENTENCE).options.max_null_count ).to eq( 5 )
+		end
+
+		it "can parse a batch of sentences" do
+			texts = [ TEST_SENTENCE, "The cat runs.", "The flag was wet." ]
+			sentences = @dict.parse_batch( texts, threads: 2 )
+
+			expect( sentences.length ).to eq( texts.length )
+			expect( sentences ).to all( be_an_instance_of(LinkParser::Sentence) )
+			expect( sentences ).to all( be_parsed )
+			expect( sentences.map(&:to_s) ).to eq( texts.map {|text| @dict.parse(text).to_s } )
+		end
+
+		it "passes on its options to the sentences in a batch" do
+			sentences = @dict.parse_batch( [TEST_SENTENCE], threads: 1, max_null_count: 4 )
+			expect( sentences.first.options.max_null_count ).to eq( 4 )
+			expect( sentences.first.options.islands_ok? ).to eq( true )
+		end
+
+		it "can parse sentences streamed from an IO" do
+			io = StringIO.new( "The cat runs.\n\nThe flag was wet.\n#{TEST_SENTENCE}\n" )
+			words = @dict.each_parse( io, batch: 2, threads: 2 ).map do |sentence|
+				sentence.linkages.first.words
+			end
+
+			expect( words.length ).to eq( 3 )
+			expect( words.first ).to eq([ 'LEFT-WALL', 'the', 'cat.n', 'runs.v', '.', 'RIGHT-WALL' ])
+		end
+
+		it "releases streamed sentences once they've been yielded" do
+			io = StringIO.new( "The cat runs.\nThe flag was wet.\n" )
+			sentences = []
+			@dict.each_parse( io ) {|sentence| sentences << sentence }
+
+			expect( sentences.length ).to eq( 2 )
+			expect( sentences ).to all( be_released )
+		end
+
+		it "can stream sentences a paragraph at a time without releasing them" do
+			io = StringIO.new( "The cat\nruns.\n\nThe flag\nwas wet.\n" )
+			sentences = @dict.each_parse( io, paragraphs: true, release: false ).to_a
+
+			expect( sentences.length ).to eq( 2 )
+			expect( sentences ).to all( be_parsed )
+			expect( sentences.first.to_s ).to eq( "LEFT-WALL the cat.n runs.v . RIGHT-WALL" )
+		end
+
+		it "raises an error if asked to parse a batch with no threads" do
+			expect {
+				@dict.parse_batch( [TEST_SENTENCE], threads: 0 )
+			}.to raise_error( ArgumentError, /thread count/i )
+		end
 	end
 
 end
@@ -0,0 +1,54 @@
+# -*- ruby -*-
+# frozen_string_literal: true
+
+require_relative '../helpers'
+
+require 'rspec'
+require 'stringio'
+require 'linkparser'
+
+
+describe LinkParser::DumpWriter do
+
+	before( :all ) do
+		@dict = LinkParser::Dictionary.new( 'en', verbosity: 0 )
+	end
+
+
+	let( :dict ) { @dict }
+	let( :io ) { StringIO.new(''.b) }
+	let( :writer ) { described_class.new(io) }
+
+
+	it "writes sentences so they can be loaded one after another" do
+		texts = [ "The cat runs.", "The flag was wet." ]
+		texts.each {|text| writer.write(dict.parse(text), text) }
+
+		expect( writer.count ).to eq( 2 )
+		expect( writer.bytes ).to eq( io.string.bytesize )
+
+		io.rewind
+		results = LinkParser.load_each( io ).to_a
+
+		expect( results.map(&:text) ).to eq( texts )
+		expect( results.map(&:subject) ).to eq( %w[cat flag] )
+	end
+
+
+	it "can write dumps that were already made" do
+		writer << dict.parse( "The cat runs." ).dump << dict.parse( "The flag was wet." )
+
+		io.rewind
+		expect( LinkParser.load_each(io).map(&:verb) ).to eq( %w[runs was] )
+	end
+
+
+	it "causes loading to fail if the stream is truncated" do
+		writer << dict.parse( "The cat runs." )
+		io.string = io.string[ 0..-3 ]
+
+		expect { LinkParser.load_each(io).to_a }.to raise_error( LinkParser::Error, /truncated/i )
+	end
+
+end
+
@@ -260,6 +260,112 @@ describe LinkParser::Linkage do
 	end
 
 
+	it "can return any one of its links" do
+		link = linkage.link( 3 )
+
+		expect( link ).to be_a( LinkParser::Linkage::Link )
+		expect( link.lword ).to eq( 'flag.n' )
+		expect( link.rword ).to eq( 'was.v-d' )
+		expect( link.length ).to eq( 1 )
+		expect( link.label ).to eq( 'Ss*s' )
+		expect( link.llabel ).to eq( 'Ss*s' )
+		expect( link.rlabel ).to eq( 'Ss' )
+		expect( link.desc ).to eq( LinkParser::Linkage::LINK_TYPES['S'] )
+		expect( link ).to eq( linkage.links[3] )
+
+		expect { linkage.link(7) }.to raise_error( IndexError )
+	end
+
+
+	it "can iterate over its links without building an Array of them" do
+		expect( linkage.each_link.to_a ).to eq( linkage.links )
+		expect( linkage.each_link.first.lword ).to be_frozen
+	end
+
+
+	it "returns the same frozen words, links, and disjunct strings every time" do
+		expect( linkage.words ).to be_frozen
+		expect( linkage.words ).to equal( linkage.words )
+		expect( linkage.words ).to all( be_frozen )
+
+		expect( linkage.links ).to be_frozen
+		expect( linkage.links ).to equal( linkage.links )
+		expect( linkage.links ).to all( be_frozen )
+		expect( linkage.links.first.lword ).to equal( linkage.words.first )
+		expect( linkage.link(0) ).to equal( linkage.links.first )
+
+		expect( linkage.disjunct_strings ).to be_frozen
+		expect( linkage.disjunct_strings ).to equal( linkage.disjunct_strings )
+	end
+
+
+	it "returns the same frozen String for the same label or word every time" do
+		other = dict.parse( "The flag was dry." ).linkages.first
+
+		expect( linkage.link_label(0) ).to be_frozen
+		expect( linkage.link_label(0) ).to equal( other.link_label(0) )
+		expect( linkage.links.first.llabel ).to equal( linkage.link_llabel(0) )
+		expect( linkage.words[2] ).to equal( other.words[2] )
+	end
+
+
+	it "can pack the links of several linkages into integer columns" do
+		labels = {}
+		columns = described_class.pack_links( [linkage, linkage], labels )
+
+		expect( columns[:offsets].unpack("l*") ).to eq( [0, 7, 14] )
+		expect( columns[:lword].unpack("l*").first(7) ).to eq( linkage.links.map {|l| linkage.words.index(l.lword) } )
+		expect( columns[:length].unpack("l*").first(7) ).to eq( linkage.links.map(&:length) )
+		expect( columns[:label].unpack("l*").first(7).map {|id| labels.key(id) } ).
+			to eq( linkage.links.map(&:label) )
+		expect( columns[:labels] ).to equal( labels )
+		expect( columns[:lword].encoding ).to eq( Encoding::BINARY )
+	end
+
+
+	it "keeps label ids the same across batches packed with the same labels" do
+		labels = {}
+		first = described_class.pack_links( [linkage], labels )
+		second = sentence.linkages.pack_links( labels )
+
+		expect( second[:label].unpack("l*").first(7) ).to eq( first[:label].unpack("l*") )
+		expect( labels.values ).to eq( (0...labels.size).to_a )
+	end
+
+
+	it "gives new labels ids after the highest one in a labels Hash with gaps in its ids" do
+		labels = { 'Wd' => 1, 'unused' => 7 }
+		columns = described_class.pack_links( [linkage], labels )
+		ids = columns[:label].unpack( "l*" )
+
+		expect( labels['Wd'] ).to eq( 1 )
+		expect( labels.values.uniq.length ).to eq( labels.length )
+		expect( (labels.values - [1, 7]) ).to all( be > 7 )
+		expect( ids.map {|id| labels.key(id) } ).to eq( linkage.links.map(&:label) )
+	end
+
+
+	it "rejects a labels Hash with ids that aren't Integers before packing any links" do
+		labels = { 'Wd' => '0' }
+
+		expect {
+			described_class.pack_links( [linkage], labels )
+		}.to raise_error( TypeError, /label ids/i )
+		expect( labels ).to eq( 'Wd' => '0' )
+	end
+
+
+	it "can be converted to a frozen result that outlives its sentence" do
+		result = linkage.to_result
+		sentence.release!
+
+		expect( result ).to be_a( LinkParser::ParseResult::Linkage ).and( be_frozen )
+		expect( result.words ).to include( 'flag.n' )
+		expect( result.links.length ).to eq( 7 )
+		expect( result.subject ).to eq( 'flag' )
+	end
+
+
 	it "knows what word is the verb in the sentence" do
 		expect( linkage.verb ).to eq( "was" )
 	end
@@ -0,0 +1,83 @@
+# -*- ruby -*-
+# frozen_string_literal: true
+
+require_relative '../helpers'
+
+require 'rspec'
+require 'linkparser'
+
+
+describe LinkParser::LinkageList do
+
+	before( :all ) do
+		@dict = LinkParser::Dictionary.new( 'en', verbosity: 0 )
+	end
+
+
+	let( :dict ) { @dict }
+	let( :sentence ) { dict.parse("The cat runs.") }
+	let( :linkages ) { sentence.linkages }
+
+
+	it "is what a sentence returns for its linkages" do
+		expect( linkages ).to be_a( described_class )
+		expect( linkages.sentence ).to equal( sentence )
+	end
+
+
+	it "knows how many linkages the sentence has" do
+		expect( linkages.size ).to eq( sentence.num_valid_linkages )
+		expect( linkages.length ).to eq( linkages.size )
+		expect( linkages ).to_not be_empty
+	end
+
+
+	it "returns the same Linkage for the same index" do
+		expect( linkages[0] ).to be_a( LinkParser::Linkage )
+		expect( linkages[0] ).to equal( sentence.linkages.first )
+		expect( linkages[-1] ).to equal( linkages[linkages.size - 1] )
+		expect( linkages[linkages.size] ).to be_nil
+	end
+
+
+	it "can return a slice of its linkages" do
+		expect( linkages[0, 2] ).to eq( [linkages[0], linkages[1]] )
+		expect( linkages[1..] ).to eq( linkages.to_a[1..] )
+		expect( linkages.first(2) ).to eq( linkages.to_a.first(2) )
+		expect( linkages.last(2) ).to eq( linkages.to_a.last(2) )
+	end
+
+
+	it "is Enumerable" do
+		expect( linkages.map(&:class).uniq ).to eq( [LinkParser::Linkage] )
+		expect( linkages.each.size ).to eq( linkages.size )
+	end
+
+
+	it "creates new Linkages after the sentence is parsed again" do
+		first = linkages.first
+		words = first.words
+		sentence.parse
+
+		expect( sentence.linkages.first ).to_not equal( first )
+		expect( first.words ).to equal( words )
+		expect { first.diagram }.to raise_error( LinkParser::Error, /parsed again/i )
+	end
+
+
+	it "invalidates Linkages that weren't fetched through it when the sentence is parsed again" do
+		linkage = LinkParser::Linkage.new( 0, sentence )
+		sentence.parse
+
+		expect { linkage.num_words }.to raise_error( LinkParser::Error, /parsed again/i )
+	end
+
+
+	it "is empty for a sentence with no linkages" do
+		sentence = dict.parse( "The event that he smiled at me gives me hope" )
+		expect( sentence.linkages.first ).to be_nil
+		expect( sentence.linkages.to_a ).to eq( [] )
+	end
+
+end
+
@@ -0,0 +1,136 @@
+# -*- ruby -*-
+# frozen_string_literal: true
+
+require_relative '../helpers'
+
+require 'rspec'
+require 'linkparser'
+
+
+describe LinkParser::ParseCache do
+
+	let( :result_class ) { Struct.new(:text, :estimated_size) }
+	let( :cache ) { described_class.new(max_entries: 3, max_bytes: 100) }
+
+
+	def result( text, size=10 )
+		return result_class.new( text, size )
+	end
+
+
+	it "normalizes the whitespace in the text it's keyed by" do
+		expect( described_class.normalize("  The  cat\truns. \n") ).to eq( "The cat runs." )
+	end
+
+
+	it "creates a result with the block on a miss and returns it on later hits" do
+		first = cache.fetch( "The cat runs." ) {|text| result(text) }
+		second = cache.fetch( " The cat  runs. " ) { raise "shouldn't be called" }
+
+		expect( second ).to equal( first )
+		expect( first.text ).to eq( "The cat runs." )
+		expect( cache.hits ).to eq( 1 )
+		expect( cache.misses ).to eq( 1 )
+	end
+
+
+	it "keys results by their options as well as their text" do
+		cache.fetch( "The cat runs.", max_null_count: 1 ) {|text| result(text) }
+		cache.fetch( "The cat runs.", max_null_count: 2 ) {|text| result(text) }
+
+		expect( cache.size ).to eq( 2 )
+		expect( cache.misses ).to eq( 2 )
+	end
+
+
+	it "evicts the least-recently-used result when it has too many" do
+		%w[one two three].each {|text| cache.fetch(text) { result(text) } }
+		cache.fetch( "one" )
+		cache.fetch( "four" ) { result("four") }
+
+		expect( cache.size ).to eq( 3 )
+		expect( cache.evictions ).to eq( 1 )
+		expect( cache.fetch("two") ).to be_nil
+		expect( cache.fetch("one") ).to_not be_nil
+	end
+
+
+	it "evicts results to stay under its size limit" do
+		cache.fetch( "one" ) { result("one", 60) }
+		cache.fetch( "two" ) { result("two", 60) }
+
+		expect( cache.size ).to eq( 1 )
+		expect( cache.bytes ).to eq( 60 )
+		expect( cache.evictions ).to eq( 1 )
+	end
+
+
+	it "doesn't store results that are bigger than the whole cache" do
+		cache.fetch( "huge" ) { result("huge", 1000) }
+		expect( cache.size ).to eq( 0 )
+	end
+
+
+	it "can report its statistics" do
+		cache.fetch( "one" ) { result("one") }
+		expect( cache.stats ).to include( entries: 1, bytes: 10, hits: 0, misses: 1, evictions: 0 )
+	end
+
+
+	it "can be cleared" do
+		cache.fetch( "one" ) { result("one") }
+		cache.clear
+
+		expect( cache.size ).to eq( 0 )
+		expect( cache.bytes ).to eq( 0 )
+	end
+
+
+	context "used by a Dictionary" do
+
+		before( :all ) do
+			@dict = LinkParser::Dictionary.new( 'en', verbosity: 0 )
+		end
+
+		after( :each ) do
+			@dict.parse_cache = nil
+		end
+
+
+		it "makes it return cached results for repeated sentences" do
+			@dict.parse_cache = described_class.new
+			first = @dict.parse_result( "The cat runs." )
+			second = @dict.parse_result( "The  cat runs." )
+
+			expect( first ).to be_a( LinkParser::ParseResult )
+			expect( second ).to equal( first )
+			expect( @dict.parse_result("The cat runs.", max_null_count: 2) ).to_not equal( first )
+			expect( @dict.parse_cache.stats ).to include( hits: 1, misses: 2 )
+		end
+
+
+		it "looks results up by the options they'd be parsed with, however they're given" do
+			@dict.parse_cache = described_class.new
+			limit = @dict.effective_options.linkage_limit
+			first = @dict.parse_result( "The cat runs." )
+
+			expect( @dict.parse_result("The cat runs.", linkage_limit: limit) ).to equal( first )
+			expect( @dict.parse_result("The cat runs.", top_k: 1) ).to_not equal( first )
+			expect( @dict.parse_result("The cat runs.", top_k: 1) ).
+				to equal( @dict.parse_result("The cat runs.", top_k: 1) )
+		end
+
+
+		it "parses the caller's text whether or not the result is cached" do
+			uncached = @dict.parse_result( "The  cat runs." )
+			@dict.parse_cache = described_class.new
+			cached = @dict.parse_result( "The  cat runs." )
+
+			expect( cached.text ).to eq( "The  cat runs." )
+			expect( cached.text ).to eq( uncached.text )
+		end
+
+	end
+
+end
+
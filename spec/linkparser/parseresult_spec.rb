@@ -0,0 +1,71 @@
+# -*- ruby -*-
+# frozen_string_literal: true
+
+require_relative '../helpers'
+
+require 'rspec'
+require 'linkparser'
+
+
+describe LinkParser::ParseResult do
+
+	before( :all ) do
+		@dict = LinkParser::Dictionary.new( 'en', verbosity: 0 )
+	end
+
+
+	let( :dict ) { @dict }
+	let( :sentence ) { dict.parse("The flag was wet.") }
+	let( :result ) { sentence.freeze_result( "The flag was wet." ) }
+
+
+	it "is created by freezing a parsed sentence" do
+		expect( result.text ).to eq( "The flag was wet." )
+		expect( result.words ).to eq( sentence.words )
+		expect( result.null_count ).to eq( sentence.null_count )
+		expect( result.num_linkages_found ).to eq( sentence.num_linkages_found )
+		expect( result.num_valid_linkages ).to eq( sentence.num_valid_linkages )
+		expect( result.to_s ).to eq( sentence.to_s )
+	end
+
+
+	it "is frozen all the way down" do
+		expect( result ).to be_frozen
+		expect( result.words ).to be_frozen.and( all(be_frozen) )
+		expect( result.linkages ).to be_frozen.and( all(be_frozen) )
+		expect( result.linkages.first.links ).to be_frozen.and( all(be_frozen) )
+	end
+
+
+	it "keeps working after its sentence has been released" do
+		result
+		sentence.release!
+
+		expect( result.words ).to include( 'flag.n' )
+		expect( result.linkages.first.links.length ).to eq( 7 )
+	end
+
+
+	it "delegates linkage queries to its first linkage like a sentence does" do
+		expect( result.verb ).to eq( sentence.verb )
+		expect( result.subject ).to eq( sentence.subject )
+		expect( result.subject(keep_subscript: true) ).to eq( "flag.n" )
+		expect( result.links ).to eq( sentence.linkages.first.links )
+		expect( result.imperative? ).to be_falsey
+	end
+
+
+	it "estimates how much memory it uses" do
+		expect( result.estimated_size ).to be > result.words.sum( &:bytesize )
+	end
+
+
+	it "raises a descriptive exception for delegated queries if there are no linkages" do
+		result = dict.parse( "The event that he smiled at me gives me hope" ).freeze_result
+
+		expect( result.linkages ).to be_empty
+		expect { result.verb }.to raise_error( LinkParser::Error, /no linkages/i )
+	end
+
+end
+
@@ -4,6 +4,7 @@
 require_relative '../helpers'
 
 require 'rspec'
+require 'objspace'
 require 'linkparser'
 
 
@@ -91,6 +92,165 @@ describe LinkParser::Sentence do
 	end
 
 
+	it "can release its link-grammar data early" do
+		linkage = sentence.linkages.first
+		words = linkage.words
+		sentence.release!
+
+		expect( sentence ).to be_released
+		expect( sentence ).to_not be_parsed
+		expect( sentence.inspect ).to match( /\(released\)/ )
+		expect { sentence.linkages }.to raise_error( LinkParser::Error, /released/i )
+		expect { linkage.diagram }.to raise_error( LinkParser::Error, /released/i )
+		expect( linkage.words ).to equal( words )
+	end
+
+
+	it "records statistics about its last parse" do
+		expect( sentence.parse_stats ).to be_nil
+
+		sentence.parse
+		stats = sentence.parse_stats
+
+		expect( stats ).to be_frozen
+		expect( stats[:parse_time] ).to be > 0
+		expect( stats[:split_time] ).to be >= 0
+		expect( stats[:timer_expired] ).to be( false )
+		expect( stats[:null_count] ).to eq( sentence.null_count )
+		expect( stats[:linkages_found] ).to eq( sentence.num_linkages_found )
+		expect( stats[:valid_linkages] ).to eq( sentence.num_valid_linkages )
+
+		sentence.release!
+		expect( sentence.parse_stats ).to eq( stats )
+	end
+
+
+	it "can be tokenized once and parsed several times without tokenizing it again" do
+		expect( sentence ).to_not be_tokenized
+
+		expect( sentence.tokenize ).to equal( sentence )
+		expect( sentence ).to be_tokenized
+		expect( sentence ).to_not be_parsed
+		expect( sentence.length ).to eq( 6 )
+
+		sentence.parse( max_null_count: 0 )
+		expect( sentence.parse_stats[:split_time] ).to eq( 0.0 )
+		sentence.parse( max_null_count: 3 )
+		expect( sentence.parse_stats[:split_time] ).to eq( 0.0 )
+	end
+
+
+	it "can keep only the best few linkages of a parse" do
+		sentence = described_class.new( "I saw the man with the telescope.", dict )
+		sentence.parse
+		best = sentence.linkage( 0 ).diagram
+
+		sentence.parse( top_k: 1 )
+
+		expect( sentence.num_linkages_found ).to be > 1
+		expect( sentence.num_valid_linkages ).to eq( 1 )
+		expect( sentence.linkage(0).diagram ).to eq( best )
+		expect( sentence.linkage(1) ).to be_nil
+		expect( sentence.options.linkage_limit ).to eq( dict.effective_options.linkage_limit )
+		expect {
+			sentence.parse( top_k: 0 )
+		}.to raise_error( ArgumentError, /top_k/ )
+	end
+
+
+	it "stops an adaptive parse at the first stage that finds linkages" do
+		expect( sentence.parse(strategy: :adaptive) ).to be > 0
+		expect( sentence.parse_stats[:stage] ).to eq( 0 )
+		expect( sentence.null_count ).to eq( 0 )
+	end
+
+
+	it "rejects unknown parse strategies" do
+		expect {
+			sentence.parse( strategy: :guess )
+		}.to raise_error( ArgumentError, /guess/ )
+	end
+
+
+	it "can dump its results so they can be loaded without a dictionary" do
+		data = sentence.dump( "The cat runs." )
+		result = LinkParser.load( data )
+
+		expect( data.encoding ).to eq( Encoding::BINARY )
+		expect( result ).to be_a( LinkParser::ParseResult )
+		expect( result.text ).to eq( "The cat runs." )
+		expect( result.words ).to eq( sentence.linkages.first.words )
+		expect( result.linkages.length ).to eq( sentence.num_valid_linkages )
+		expect( result.links ).to eq( sentence.linkages.first.links )
+		expect( result.disjunct_strings ).to eq( sentence.linkages.first.disjunct_strings )
+		expect( result.verb ).to eq( sentence.verb )
+	end
+
+
+	it "refuses to load data that isn't a dump" do
+		expect { LinkParser.load("nope") }.to raise_error( LinkParser::Error, /truncated|not a/i )
+		expect { LinkParser.load(sentence.dump[0..-2]) }.to raise_error( LinkParser::Error, /truncated/i )
+	end
+
+
+	it "can freeze its results so they can be kept after it's released" do
+		result = sentence.freeze_result( "The cat runs." )
+		sentence.release!
+
+		expect( result ).to be_a( LinkParser::ParseResult ).and( be_frozen )
+		expect( result.text ).to eq( "The cat runs." )
+		expect( result.linkages.first.verb ).to eq( 'runs' )
+	end
+
+
+	it "reports its size to ObjectSpace" do
+		expect( ObjectSpace.memsize_of(sentence) ).to be > ObjectSpace.memsize_of( Object.new )
+	end
+
+
+	it "includes an estimate of link-grammar's memory use in its size" do
+		unparsed_size = ObjectSpace.memsize_of( sentence )
+		sentence.parse
+		parsed_size = ObjectSpace.memsize_of( sentence )
+
+		expect( parsed_size ).to be > unparsed_size
+
+		sentence.release!
+		expect( ObjectSpace.memsize_of(sentence) ).to be < parsed_size
+	end
+
+
+	it "outlives the Dictionary object it was created from" do
+		sentence = LinkParser::Dictionary.new( 'en', verbosity: 0 ).parse( "The cat runs." )
+		GC.start
+
+		expect( sentence.linkages.first.words ).to include( 'cat.n' )
+	end
+
+
+	it "can be parsed concurrently with other sentences from the same dictionary" do
+		texts = [
+			"The cat runs.",
+			"The flag was wet.",
+			"The dog plays with the ball.",
+			"People use Ruby for all kinds of nifty things.",
+		]
+		expected = texts.map {|text| dict.parse(text).linkages.map(&:diagram) }
+
+		threads = 8.times.map do
+			Thread.new do
+				25.times.flat_map do
+					texts.map {|text| dict.parse(text).linkages.map(&:diagram) }
+				end
+			end
+		end
+
+		threads.map( &:value ).each do |results|
+			expect( results.each_slice(texts.length).to_a ).to all( eq(expected) )
+		end
+	end
+
+
 
 	describe "parsed from a sentence with a superfluous word in it" do
 
@@ -107,11 +267,75 @@ describe LinkParser::Sentence do
 	end
 
 
+	describe "parsed from a pathologically long sentence" do
+
+		let( :sentence ) do
+			described_class.new( (["The dog that chased the cat the rat bit ran"] * 12).join(' and '), dict )
+		end
+
+
+		# An exception raised into the thread that's parsing the sentence
+		let( :interruption ) { Class.new(StandardError) }
+
+
+		### Start parsing the sentence in a new thread, wait until the parse is
+		### underway, and then interrupt it.
+		def parse_and_interrupt( sentence )
+			parser = Thread.new do
+				Thread.current.report_on_exception = false
+				sentence.parse( min_null_count: 1, max_null_count: 100, max_parse_time: 60 )
+			end
+
+			until sentence.parsing?
+				raise "the parse finished before it could be interrupted" unless parser.alive?
+				Thread.pass
+			end
+
+			parser.raise( interruption )
+			return parser
+		end
+
+
+		it "can be interrupted while it's being parsed" do
+			parser = parse_and_interrupt( sentence )
+
+			expect { parser.join }.to raise_error( interruption )
+			expect( sentence ).to be_aborted
+			expect( sentence ).to_not be_parsed
+			expect( sentence.inspect ).to match( /\(aborted\)/ )
+		end
+
+
+		it "can be re-parsed after being interrupted" do
+			parser = parse_and_interrupt( sentence )
+			expect { parser.join }.to raise_error( interruption )
+
+			sentence.parse( max_null_count: 0, max_parse_time: 1 )
+
+			expect( sentence ).to be_parsed
+			expect( sentence ).to_not be_aborted
+			expect( sentence.options.max_parse_time ).to eq( 1 )
+		end
+
+	end
+
+
 	describe "parsed from a sentence that yields no linkages" do
 
 		let( :sentence ) { dict.parse("The event that he smiled at me gives me hope") }
 
 
+		it "can escalate to more expensive options with an adaptive parse" do
+			sentence = described_class.new( "The event that he smiled at me gives me hope", dict )
+			ladder = [ {max_null_count: 0}, {min_null_count: 1, max_null_count: 5} ]
+
+			expect( sentence.parse(strategy: :adaptive, ladder: ladder) ).to be > 0
+			expect( sentence.parse_stats[:stage] ).to eq( 1 )
+			expect( sentence.null_count ).to be > 0
+			expect( sentence.options.max_null_count ).to eq( 5 )
+		end
+
+
 		it "raises a descriptive exception if a delegated method is called" do
 			expect {
 				sentence.diagram
@@ -18,5 +18,138 @@ describe LinkParser do
 		expect( LinkParser.link_grammar_config ).to match( /compiled with:/i )
 	end
 
+
+	it "adds up the statistics of every parse" do
+		dict = LinkParser::Dictionary.new( 'en', verbosity: 0 )
+		LinkParser.reset_parse_stats
+
+		2.times { dict.parse("The cat runs.") }
+		stats = LinkParser.parse_stats
+
+		expect( stats[:parses] ).to eq( 2 )
+		expect( stats[:parse_time][:count] ).to eq( 2 )
+		expect( stats[:parse_time][:buckets].values.sum ).to eq( 2 )
+		expect( stats[:parse_time][:buckets].keys.last ).to eq( Float::INFINITY )
+	end
+
+
+	describe "instrumentation" do
+
+		after( :each ) do
+			subscribers = LinkParser.instance_variable_get( :@subscribers ).values.flatten.uniq
+			subscribers.each {|sub| LinkParser.unsubscribe(sub) }
+		end
+
+
+		it "doesn't build events that don't have any subscribers" do
+			expect( LinkParser.refresh_subscriptions ).to eq( 0 )
+			expect( LinkParser ).to_not receive( :publish_event )
+
+			LinkParser::Dictionary.new( 'en', verbosity: 0 ).parse( "The cat runs." ).linkages.first
+		end
+
+
+		it "publishes events about dictionary loads, parses, and linkages to subscribers" do
+			events = []
+			subscriber = LinkParser.subscribe {|event| events << event }
+
+			dict = LinkParser::Dictionary.new( 'en', verbosity: 0 )
+			sentence = dict.parse( "The cat runs." )
+			sentence.linkages.first
+
+			expect( events.map(&:name).first(2) ).to eq([ :dictionary_load, :parse ])
+			expect( events.map(&:name).uniq ).to include( :linkage )
+			expect( events ).to all( be_frozen )
+
+			parse = events.find {|event| event.name == :parse }
+			expect( parse.duration ).to be_a( Float )
+			expect( parse.payload ).to include( length: sentence.length, outcome: :success )
+			expect( parse.payload[:options] ).to be_frozen.
+				and( include(max_null_count: sentence.options.max_null_count) )
+			expect( parse.payload[:options_fingerprint] ).
+				to eq( LinkParser.options_fingerprint(sentence.options.to_hash) )
+
+			expect( LinkParser.unsubscribe(subscriber) ).to be( true )
+			expect( LinkParser.refresh_subscriptions ).to eq( 0 )
+		end
+
+
+		it "fingerprints parse options the same way whatever order they're in" do
+			fingerprint = LinkParser.options_fingerprint( verbosity: 1, max_null_count: 0 )
+
+			expect( LinkParser.options_fingerprint(max_null_count: 0, verbosity: 1) ).to eq( fingerprint )
+			expect( LinkParser.options_fingerprint(max_null_count: 1, verbosity: 1) ).to_not eq( fingerprint )
+			expect( fingerprint ).to eq( Zlib.crc32('[["max_null_count", 0], ["verbosity", 1]]') )
+		end
+
+
+		it "only publishes the events a subscriber asked for" do
+			events = []
+			LinkParser.subscribe( :linkage ) {|event| events << event }
+
+			dict = LinkParser::Dictionary.new( 'en', verbosity: 0 )
+			dict.parse( "The cat runs." ).linkages.first
+
+			expect( events ).to_not be_empty
+			expect( events.map(&:name).uniq ).to eq([ :linkage ])
+			expect( events.first.payload ).to include( :index, :num_words, :num_links )
+		end
+
+
+		it "logs and ignores errors raised by subscribers" do
+			LinkParser.subscribe( :dictionary_load ) {|event| raise "oops" }
+			expect( LinkParser.log ).to receive( :error ).with( /RuntimeError.*oops/ )
+
+			expect {
+				LinkParser::Dictionary.new( 'en', verbosity: 0 )
+			}.to_not raise_error
+		end
+
+
+		it "rejects subscriptions to unknown events" do
+			expect {
+				LinkParser.subscribe( :parse, :lunch ) {}
+			}.to raise_error( ArgumentError, /lunch/ )
+		end
+
+	end
+
+
+	describe "logging" do
+
+		before( :each ) do
+			@original_logger = LinkParser.logger
+			@original_level = LinkParser.logger.level
+		end
+
+		after( :each ) do
+			LinkParser.logger = @original_logger
+			LinkParser.logger.level = @original_level
+		end
+
+
+		it "keeps the extension's copy of the logger's level up to date" do
+			LinkParser.logger.level = :error
+			expect( LinkParser.refresh_log_level ).to eq( Logger::ERROR )
+
+			LinkParser.logger.level = :debug
+			expect( LinkParser.refresh_log_level ).to eq( Logger::DEBUG )
+		end
+
+
+		it "keeps the extension's copy of the logger's level up to date if the logger is replaced" do
+			logger = Loggability::Logger.new( $stderr )
+			logger.level = :warn
+			LinkParser.logger = logger
+
+			expect( LinkParser.refresh_log_level ).to eq( Logger::WARN )
+
+			logger.level = :info
+			expect( LinkParser.refresh_log_level ).to eq( Logger::INFO )
+		end
+
+	end
+
+
 end
 